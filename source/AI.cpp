@@ -26,6 +26,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Random.h"
 #include "Ship.h"
 #include "ShipEvent.h"
+#include "ShipRegistry.h"
 #include "System.h"
 
 #include <SDL2/SDL.h>
@@ -37,6 +38,22 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 using namespace std;
 
 namespace {
+	// Attributes that the AI checks every step.
+	const unsigned AFTERBURNER_FUEL = Outfit::Index("afterburner fuel");
+	const unsigned AFTERBURNER_THRUST = Outfit::Index("afterburner thrust");
+	const unsigned ATMOSPHERE_SCAN = Outfit::Index("atmosphere scan");
+	const unsigned CARGO_SCAN = Outfit::Index("cargo scan");
+	const unsigned CLOAK = Outfit::Index("cloak");
+	const unsigned CLOAKING_FUEL = Outfit::Index("cloaking fuel");
+	const unsigned FUEL_CAPACITY = Outfit::Index("fuel capacity");
+	const unsigned HYPERDRIVE = Outfit::Index("hyperdrive");
+	const unsigned JUMP_DRIVE = Outfit::Index("jump drive");
+	const unsigned JUMP_SPEED = Outfit::Index("jump speed");
+	const unsigned OUTFIT_SCAN = Outfit::Index("outfit scan");
+	const unsigned RAMSCOOP = Outfit::Index("ramscoop");
+	const unsigned REVERSE_THRUST = Outfit::Index("reverse thrust");
+	const unsigned SCRAM_DRIVE = Outfit::Index("scram drive");
+	
 	const Command &AutopilotCancelKeys()
 	{
 		static const Command keys(Command::LAND | Command::JUMP | Command::BOARD
@@ -48,7 +65,7 @@ namespace {
 	bool IsStranded(const Ship &ship)
 	{
 		return ship.GetSystem() && !ship.GetSystem()->IsInhabited()
-			&& ship.Attributes().Get("fuel capacity") && !ship.JumpsRemaining();
+			&& ship.Attributes().Get(FUEL_CAPACITY) && !ship.JumpsRemaining();
 	}
 	
 	bool CanBoard(const Ship &ship, const Ship &target)
@@ -62,7 +79,17 @@ namespace {
 		return target.IsDisabled();
 	}
 	
+	// A weapon that AutoFire() is checking against each of the enemy ships.
+	struct AimedWeapon {
+		int index;
+		Point start;
+		Point velocity;
+		double lifetime;
+	};
+	
 	static const double MAX_DISTANCE_FROM_CENTER = 10000.;
+	// Ships only cloak to avoid enemies that are closer than this.
+	static const double MAX_ENEMY_RANGE = 10000.;
 }
 
 
@@ -95,7 +122,7 @@ void AI::UpdateKeys(PlayerInfo &player, Command &clickCommands, bool isActive)
 	// Only toggle the "cloak" command if one of your ships has a cloaking device.
 	if(keyDown.Has(Command::CLOAK))
 		for(const auto &it : player.Ships())
-			if(it->Attributes().Get("cloak"))
+			if(it->Attributes().Get(CLOAK))
 			{
 				isCloaking = !isCloaking;
 				Messages::Add(isCloaking ? "Engaging cloaking device." : "Disengaging cloaking device.");
@@ -187,13 +214,14 @@ void AI::Clean()
 
 
 
-void AI::Step(const list<shared_ptr<Ship>> &ships, const PlayerInfo &player)
+void AI::Step(const ShipRegistry &ships, const PlayerInfo &player)
 {
 	// First, figure out the comparative strengths of the present governments.
+	const System *playerSystem = player.GetSystem();
 	map<const Government *, int64_t> strength;
-	for(const auto &it : ships)
-		if(it->GetGovernment() && it->GetSystem() == player.GetSystem() && !it->IsDisabled())
-			strength[it->GetGovernment()] += it->Cost();
+	for(unsigned i = 0; i < ships.Size(); ++i)
+		if(ships.GetGovernment(i) && ships.GetSystem(i) == playerSystem && !ships.Is(i, ShipRegistry::DISABLED))
+			strength[ships.GetGovernment(i)] += ships.Cost(i);
 	enemyStrength.clear();
 	allyStrength.clear();
 	for(const auto &it : strength)
@@ -211,40 +239,49 @@ void AI::Step(const list<shared_ptr<Ship>> &ships, const PlayerInfo &player)
 					}
 			}
 	}
-	shipStrength.clear();
-	for(const auto &it : ships)
+	shipStrength.assign(ships.Size(), 0);
+	for(unsigned i = 0; i < ships.Size(); ++i)
 	{
-		const Government *gov = it->GetGovernment();
-		if(!gov || it->GetSystem() != player.GetSystem() || it->IsDisabled())
+		const Government *gov = ships.GetGovernment(i);
+		if(!gov || ships.GetSystem(i) != playerSystem || ships.Is(i, ShipRegistry::DISABLED))
 			continue;
-		int64_t &strength = shipStrength[it.get()];
-		for(const auto &oit : ships)
+		int64_t &strength = shipStrength[i];
+		for(unsigned j = 0; j < ships.Size(); ++j)
 		{
-			const Government *ogov = oit->GetGovernment();
-			if(!ogov || oit->GetSystem() != player.GetSystem() || oit->IsDisabled())
+			const Government *ogov = ships.GetGovernment(j);
+			if(!ogov || ships.GetSystem(j) != playerSystem || ships.Is(j, ShipRegistry::DISABLED))
 				continue;
 			
-			if(ogov->AttitudeToward(gov) > 0. && oit->Position().Distance(it->Position()) < 2000.)
-				strength += it->Cost();
+			if(ogov->AttitudeToward(gov) > 0. && ships.Position(j).Distance(ships.Position(i)) < 2000.)
+				strength += ships.Cost(i);
 		}
 	}		
 	
 	const Ship *flagship = player.Flagship();
 	step = (step + 1) & 31;
+	
+	// The AI works in three phases. First, a quick serial pass handles anything
+	// that one ship does to another (e.g. disabled ships calling for help), and
+	// any random choices. Second, the expensive decisions, which involve looking
+	// at every other ship, are made for all the ships in parallel. Those only
+	// read the state of the ships, so the results do not depend on how many
+	// threads there are. Finally, a serial pass applies those decisions and
+	// works out how each ship should move.
+	decisions.clear();
 	int targetTurn = 0;
-	for(const auto &it : ships)
+	for(unsigned i = 0; i < ships.Size(); ++i)
 	{
-		// Skip any carried fighters or drones that are somehow in the list.
-		if(!it->GetSystem())
-			continue;
-		
+		shared_ptr<Ship> it = ships.Shared(i);
+		// Make sure the first use of any ship's collision mask (which may pick
+		// a random animation frame) happens here, and not in the parallel phase.
+		it->GetSprite().GetMask(step);
 		if(it.get() == flagship)
 		{
 			MovePlayer(*it, player, ships);
 			continue;
 		}
 		
-		bool isPresent = (it->GetSystem() == player.GetSystem());
+		bool isPresent = (ships.GetSystem(i) == playerSystem);
 		bool isStranded = IsStranded(*it);
 		if(isStranded || it->IsDisabled())
 		{
@@ -256,19 +293,21 @@ void AI::Step(const list<shared_ptr<Ship>> &ships, const PlayerInfo &player)
 			bool selectNext = false;
 			Ship *nextAlly = nullptr;
 			const Government *gov = it->GetGovernment();
-			for(const auto &ship : ships)
+			for(unsigned j = 0; j < ships.Size(); ++j)
 			{
-				if(ship->IsDisabled() || !ship->IsTargetable() || ship->GetSystem() != it->GetSystem())
+				if(ships.Is(j, ShipRegistry::DISABLED) || !ships.Is(j, ShipRegistry::TARGETABLE)
+						|| ships.GetSystem(j) != ships.GetSystem(i))
 					continue;
 				
-				const Government *otherGov = ship->GetGovernment();
+				Ship *ship = &ships.Get(j);
+				const Government *otherGov = ships.GetGovernment(j);
 				// If any enemies of this ship are in system, it cannot call for help.
 				if(otherGov->IsEnemy(gov) && isPresent)
 				{
 					hasEnemy = true;
 					break;
 				}
-				if((otherGov->IsPlayer() && !gov->IsPlayer()) || ship.get() == flagship)
+				if((otherGov->IsPlayer() && !gov->IsPlayer()) || ship == flagship)
 					continue;
 				
 				if(it->IsDisabled() ? (otherGov == gov) : (!otherGov->IsEnemy(gov)))
@@ -277,11 +316,11 @@ void AI::Step(const list<shared_ptr<Ship>> &ships, const PlayerInfo &player)
 						continue;
 					
 					if(!firstAlly)
-						firstAlly = &*ship;
-					else if(ship == it)
+						firstAlly = ship;
+					else if(j == i)
 						selectNext = true;
 					else if(selectNext && !nextAlly)
-						nextAlly = &*ship;
+						nextAlly = ship;
 				}
 			}
 			
@@ -326,23 +365,60 @@ void AI::Step(const list<shared_ptr<Ship>> &ships, const PlayerInfo &player)
 		if(parent && personality.IsCoward() && it->Shields() + it->Hull() < 1.)
 			it->SetParent(shared_ptr<Ship>());
 		
-		// Fire any weapons that will hit the target. Only ships that are in
-		// the current system can fire.
-		shared_ptr<const Ship> target = it->GetTargetShip();
+		decisions.emplace_back(it, command, isPresent, isStranded);
+		Decision &decision = decisions.back();
 		if(isPresent)
 		{
-			command |= AutoFire(*it, ships);
-			
 			// Each ship only switches targets twice a second, so that it can
 			// focus on damaging one particular ship.
+			shared_ptr<const Ship> target = it->GetTargetShip();
 			targetTurn = (targetTurn + 1) & 31;
-			if(targetTurn == step || !target || !target->IsTargetable()
-					|| (target->IsDisabled() && personality.Disables()))
-				it->SetTargetShip(FindTarget(*it, ships));
+			decision.findTarget = (targetTurn == step || !target || !target->IsTargetable()
+				|| (target->IsDisabled() && personality.Disables()));
+			
+			// The pilot's aim wanders randomly, so update it here rather than
+			// in the parallel phase.
+			decision.confusion = personality.Confusion();
+		}
+	}
+	
+	// Make all the decisions that require searching through the other ships.
+	pool.Run(decisions.size(), [this, &ships](unsigned i)
+	{
+		Decision &decision = decisions[i];
+		const Ship &ship = *decision.ship;
+		if(decision.isPresent)
+		{
+			// Fire any weapons that will hit the target. Only ships that are in
+			// the current system can fire.
+			decision.autoFire = AutoFire(ship, ships, decision.confusion);
+			if(decision.findTarget)
+				decision.target = FindTarget(ship, ships);
+		}
+		// Only ships that may decide to cloak need to know where the nearest
+		// enemy is.
+		if(!ship.IsYours() && ship.Attributes().Get(CLOAK))
+			decision.nearestEnemy = NearestEnemy(ship, ships);
+		decision.scatter = Scatter(ship, ships);
+	});
+	
+	for(Decision &decision : decisions)
+	{
+		const shared_ptr<Ship> &it = decision.ship;
+		Command command = decision.command;
+		bool isStranded = decision.isStranded;
+		const Personality &personality = it->GetPersonality();
+		shared_ptr<Ship> parent = it->GetParent();
+		
+		if(decision.isPresent)
+		{
+			command |= decision.autoFire;
+			if(decision.findTarget)
+				it->SetTargetShip(decision.target);
 		}
 		
 		double targetDistance = numeric_limits<double>::infinity();
-		target = it->GetTargetShip();
+		shared_ptr<const Ship> target = it->GetTargetShip();
 		if(target)
 			targetDistance = target->Position().Distance(it->Position());
 		
@@ -358,14 +434,17 @@ void AI::Step(const list<shared_ptr<Ship>> &ships, const PlayerInfo &player)
 			if(!hasSpace || parent->IsDestroyed() || parent->GetSystem() != it->GetSystem())
 			{
 				// Handle orphaned fighters and drones.
-				for(const auto &other : ships)
-					if(other->GetGovernment() == it->GetGovernment() && !other->IsDisabled()
-							&& other->GetSystem() == it->GetSystem())
-						if((isDrone && other->DroneBaysFree()) || (isFighter && other->FighterBaysFree()))
+				for(unsigned i = 0; i < ships.Size(); ++i)
+					if(ships.GetGovernment(i) == it->GetGovernment() && !ships.Is(i, ShipRegistry::DISABLED)
+							&& ships.GetSystem(i) == it->GetSystem())
+					{
+						const Ship &other = ships.Get(i);
+						if((isDrone && other.DroneBaysFree()) || (isFighter && other.FighterBaysFree()))
 						{
-							it->SetParent(other);
+							it->SetParent(ships.Shared(i));
 							break;
 						}
+					}
 			}
 			else if(parent && !(it->IsYours() ? isLaunching : parent->Commands().Has(Command::DEPLOY)))
 			{
@@ -423,7 +502,7 @@ void AI::Step(const list<shared_ptr<Ship>> &ships, const PlayerInfo &player)
 			MoveIndependent(*it, command);
 		else if(parent->GetSystem() != it->GetSystem())
 		{
-			if(personality.IsStaying() || !it->Attributes().Get("fuel capacity"))
+			if(personality.IsStaying() || !it->Attributes().Get(FUEL_CAPACITY))
 				MoveIndependent(*it, command);
 			else
 				MoveEscort(*it, command);
@@ -456,21 +535,22 @@ void AI::Step(const list<shared_ptr<Ship>> &ships, const PlayerInfo &player)
 		
 		// Apply the afterburner if you're in a heated battle and it will not
 		// use up your last jump worth of fuel.
-		if(it->Attributes().Get("afterburner thrust") && target && !target->IsDisabled()
+		if(it->Attributes().Get(AFTERBURNER_THRUST) && target && !target->IsDisabled()
 				&& target->IsTargetable() && target->GetSystem() == it->GetSystem())
 		{
-			double fuel = it->Fuel() * it->Attributes().Get("fuel capacity");
-			if(fuel - it->Attributes().Get("afterburner fuel") >= it->JumpFuel())
+			double fuel = it->Fuel() * it->Attributes().Get(FUEL_CAPACITY);
+			if(fuel - it->Attributes().Get(AFTERBURNER_FUEL) >= it->JumpFuel())
 				if(command.Has(Command::FORWARD) && targetDistance < 1000.)
 					command |= Command::AFTERBURNER;
 		}
 		// Your own ships cloak on your command; all others do it when the
 		// AI considers it appropriate.
 		if(!it->IsYours())
-			DoCloak(*it, command, ships);
+			DoCloak(*it, command, decision.nearestEnemy);
 		
 		// Force ships that are overlapping each other to "scatter":
-		DoScatter(*it, command, ships);
+		if(decision.scatter && command.Has(Command::FORWARD))
+			command.SetTurn(decision.scatter);
 		
 		it->SetCommands(command);
 	}
@@ -479,7 +559,7 @@ void AI::Step(const list<shared_ptr<Ship>> &ships, const PlayerInfo &player)
 
 
 // Pick a new target for the given ship.
-shared_ptr<Ship> AI::FindTarget(const Ship &ship, const list<shared_ptr<Ship>> &ships) const
+shared_ptr<Ship> AI::FindTarget(const Ship &ship, const ShipRegistry &ships) const
 {
 	// If this ship has no government, it has no enemies.
 	shared_ptr<Ship> target;
@@ -532,69 +612,68 @@ shared_ptr<Ship> AI::FindTarget(const Ship &ship, const list<shared_ptr<Ship>> &
 	bool isDisabled = false;
 	// Figure out how strong this ship is.
 	int64_t maxStrength = 0;
-	auto strengthIt = shipStrength.find(&ship);
-	if(!person.IsHeroic() && strengthIt != shipStrength.end())
-		maxStrength = 2 * strengthIt->second;
-	for(const auto &it : ships)
-		if(it->GetSystem() == system && it->IsTargetable() && gov->IsEnemy(it->GetGovernment()))
+	unsigned index = ships.Find(ship);
+	if(!person.IsHeroic() && index < shipStrength.size())
+		maxStrength = 2 * shipStrength[index];
+	for(unsigned i = 0; i < ships.Size(); ++i)
+		if(ships.GetSystem(i) == system && ships.Is(i, ShipRegistry::TARGETABLE) && gov->IsEnemy(ships.GetGovernment(i)))
 		{
-			if(person.IsNemesis() && !it->GetGovernment()->IsPlayer())
+			if(person.IsNemesis() && !ships.GetGovernment(i)->IsPlayer())
 				continue;
 			
 			// Calculate what the range will be a second from now, so that ships
 			// will prefer targets that they are headed toward.
-			double range = (it->Position() + 60. * it->Velocity()).Distance(
+			const Ship *it = &ships.Get(i);
+			double range = (ships.Position(i) + 60. * ships.Velocity(i)).Distance(
 				ship.Position() + 60. * ship.Velocity());
 			// Preferentially focus on your previous target or your parent ship's
 			// target if they are nearby.
-			if(it == oldTarget || it == parentTarget)
+			if(it == oldTarget.get() || it == parentTarget.get())
 				range -= 500.;
 			
 			// Unless this ship is heroic, it will not chase much stronger ships
 			// unless it has strong allies nearby.
-			if(maxStrength && range > 1000. && !it->IsDisabled())
-			{
-				auto otherStrengthIt = shipStrength.find(it.get());
-				if(otherStrengthIt != shipStrength.end() && otherStrengthIt->second > maxStrength)
-					continue;
-			}
+			bool itIsDisabled = ships.Is(i, ShipRegistry::DISABLED);
+			if(maxStrength && range > 1000. && !itIsDisabled && shipStrength[i] > maxStrength)
+				continue;
 			
 			// If your personality it to disable ships rather than destroy them,
 			// never target disabled ships.
-			if(it->IsDisabled() && !person.Plunders()
-					&& (person.Disables() || (!person.IsNemesis() && it != oldTarget)))
+			if(itIsDisabled && !person.Plunders()
+					&& (person.Disables() || (!person.IsNemesis() && it != oldTarget.get())))
 				continue;
 			
 			if(!person.Plunders())
-				range += 5000. * it->IsDisabled();
+				range += 5000. * itIsDisabled;
 			else
 			{
-				bool hasBoarded = Has(ship, it, ShipEvent::BOARD);
+				bool hasBoarded = Has(ship, ships.Shared(i), ShipEvent::BOARD);
 				// Don't plunder unless there are no "live" enemies nearby.
-				range += 2000. * (2 * it->IsDisabled() - !hasBoarded);
+				range += 2000. * (2 * itIsDisabled - !hasBoarded);
 			}
 			// Focus on nearly dead ships.
 			range += 500. * (it->Shields() + it->Hull());
 			if(range < closest)
 			{
 				closest = range;
-				target = it;
-				isDisabled = it->IsDisabled();
+				target = ships.Shared(i);
+				isDisabled = itIsDisabled;
 			}
 		}
 	
-	bool cargoScan = ship.Attributes().Get("cargo scan");
-	bool outfitScan = ship.Attributes().Get("outfit scan");
+	bool cargoScan = ship.Attributes().Get(CARGO_SCAN);
+	bool outfitScan = ship.Attributes().Get(OUTFIT_SCAN);
 	if(!target && (cargoScan || outfitScan) && !isPlayerEscort)
 	{
 		closest = numeric_limits<double>::infinity();
-		for(const auto &it : ships)
-			if(it->GetSystem() == system && it->GetGovernment() != gov && it->IsTargetable())
+		for(unsigned i = 0; i < ships.Size(); ++i)
+			if(ships.GetSystem(i) == system && ships.GetGovernment(i) != gov && ships.Is(i, ShipRegistry::TARGETABLE))
 			{
+				shared_ptr<Ship> it = ships.Shared(i);
 				if((cargoScan && !Has(ship.GetGovernment(), it, ShipEvent::SCAN_CARGO))
 						|| (outfitScan && !Has(ship.GetGovernment(), it, ShipEvent::SCAN_OUTFITS)))
 				{
-					double range = it->Position().Distance(ship.Position());
+					double range = ships.Position(i).Distance(ship.Position());
 					if(range < closest)
 					{
 						closest = range;
@@ -609,7 +688,7 @@ shared_ptr<Ship> AI::FindTarget(const Ship &ship, const list<shared_ptr<Ship>> &
 	{
 		// Make sure the ship has somewhere to flee to.
 		const System *system = ship.GetSystem();
-		if(ship.JumpsRemaining() && (!system->Links().empty() || ship.Attributes().Get("jump drive")))
+		if(ship.JumpsRemaining() && (!system->Links().empty() || ship.Attributes().Get(JUMP_DRIVE)))
 			target.reset();
 		else
 			for(const StellarObject &object : system->Objects())
@@ -664,8 +743,8 @@ void AI::MoveIndependent(Ship &ship, Command &command) const
 	}
 	else if(target)
 	{
-		bool cargoScan = ship.Attributes().Get("cargo scan");
-		bool outfitScan = ship.Attributes().Get("outfit scan");
+		bool cargoScan = ship.Attributes().Get(CARGO_SCAN);
+		bool outfitScan = ship.Attributes().Get(OUTFIT_SCAN);
 		if((!cargoScan || Has(ship.GetGovernment(), target, ShipEvent::SCAN_CARGO))
 				&& (!outfitScan || Has(ship.GetGovernment(), target, ShipEvent::SCAN_OUTFITS)))
 			target.reset();
@@ -696,7 +775,7 @@ void AI::MoveIndependent(Ship &ship, Command &command) const
 		
 		vector<int> systemWeights;
 		int totalWeight = 0;
-		const vector<const System *> &links = ship.Attributes().Get("jump drive")
+		const vector<const System *> &links = ship.Attributes().Get(JUMP_DRIVE)
 			? ship.GetSystem()->Neighbors() : ship.GetSystem()->Links();
 		if(jumps)
 		{
@@ -782,7 +861,7 @@ void AI::MoveEscort(Ship &ship, Command &command)
 	bool isStaying = ship.GetPersonality().IsStaying();
 	// If an escort is out of fuel, they should refuel without waiting for the
 	// "parent" to land (because the parent may not be planning on landing).
-	if(ship.Attributes().Get("fuel capacity") && !ship.JumpsRemaining() && ship.GetSystem()->IsInhabited())
+	if(ship.Attributes().Get(FUEL_CAPACITY) && !ship.JumpsRemaining() && ship.GetSystem()->IsInhabited())
 		Refuel(ship, command);
 	else if(ship.GetSystem() != parent.GetSystem() && !isStaying)
 	{
@@ -945,7 +1024,7 @@ bool AI::Stop(Ship &ship, Command &command, double slow)
 	if(speed <= slow)
 		return true;
 	
-	if(ship.Attributes().Get("reverse thrust"))
+	if(ship.Attributes().Get(REVERSE_THRUST))
 	{
 		// Figure out your stopping time using your main engine:
 		double degreesToTurn = TO_DEG * acos(min(1., max(-1., -velocity.Unit().Dot(angle.Unit()))));
@@ -953,7 +1032,7 @@ bool AI::Stop(Ship &ship, Command &command, double slow)
 		forwardTime += speed / ship.Acceleration();
 		
 		// Figure out your reverse thruster stopping time:
-		double reverseAcceleration = ship.Attributes().Get("reverse thrust") / ship.Mass();
+		double reverseAcceleration = ship.Attributes().Get(REVERSE_THRUST) / ship.Mass();
 		double reverseTime = (180. - degreesToTurn) / ship.TurnRate();
 		reverseTime += speed / reverseAcceleration;
 		
@@ -988,7 +1067,7 @@ void AI::PrepareForHyperspace(Ship &ship, Command &command)
 		Point normal(-direction.Y(), direction.X());
 		
 		double deviation = ship.Velocity().Dot(normal);
-		if(fabs(deviation) > ship.Attributes().Get("scram drive"))
+		if(fabs(deviation) > ship.Attributes().Get(SCRAM_DRIVE))
 		{
 			// Need to maneuver; not ready to jump
 			if((ship.Facing().Unit().Dot(normal) < 0) == (deviation < 0))
@@ -1006,7 +1085,7 @@ void AI::PrepareForHyperspace(Ship &ship, Command &command)
 				double correctionWhileTurning = fabs(1 - cos) * ship.Acceleration() / turnRateRadians;
 				// (Note that this will always underestimate because thrust happens before turn)
 				
-				if(fabs(deviation) - correctionWhileTurning > ship.Attributes().Get("scram drive"))
+				if(fabs(deviation) - correctionWhileTurning > ship.Attributes().Get(SCRAM_DRIVE))
 					// Want to thrust from an even sharper angle
 					direction = -deviation * normal;
 			}
@@ -1014,7 +1093,7 @@ void AI::PrepareForHyperspace(Ship &ship, Command &command)
 		command.SetTurn(TurnToward(ship, direction));
 	}
 	// If we are moving too fast, point in the right direction.
-	else if(Stop(ship, command, ship.Attributes().Get("jump speed")))
+	else if(Stop(ship, command, ship.Attributes().Get(JUMP_SPEED)))
 	{
 		if(type != 200)
 			command.SetTurn(TurnToward(ship, direction));
@@ -1090,7 +1169,7 @@ void AI::Attack(Ship &ship, Command &command, const Ship &target)
 
 
 
-void AI::DoSurveillance(Ship &ship, Command &command, const list<shared_ptr<Ship>> &ships) const
+void AI::DoSurveillance(Ship &ship, Command &command, const ShipRegistry &ships) const
 {
 	const shared_ptr<Ship> &target = ship.GetTargetShip();
 	if(target && (!target->IsTargetable() || target->GetSystem() != ship.GetSystem()))
@@ -1098,15 +1177,15 @@ void AI::DoSurveillance(Ship &ship, Command &command, const list<shared_ptr<Ship
 	if(target && ship.GetGovernment()->IsEnemy(target->GetGovernment()))
 	{
 		MoveIndependent(ship, command);
-		command |= AutoFire(ship, ships);
+		command |= AutoFire(ship, ships, ship.GetPersonality().Confusion());
 		return;
 	}
 	
-	bool cargoScan = ship.Attributes().Get("cargo scan");
-	bool outfitScan = ship.Attributes().Get("outfit scan");
-	double atmosphereScan = ship.Attributes().Get("atmosphere scan");
-	bool jumpDrive = ship.Attributes().Get("jump drive");
-	bool hyperdrive = ship.Attributes().Get("hyperdrive");
+	bool cargoScan = ship.Attributes().Get(CARGO_SCAN);
+	bool outfitScan = ship.Attributes().Get(OUTFIT_SCAN);
+	double atmosphereScan = ship.Attributes().Get(ATMOSPHERE_SCAN);
+	bool jumpDrive = ship.Attributes().Get(JUMP_DRIVE);
+	bool hyperdrive = ship.Attributes().Get(HYPERDRIVE);
 	
 	// This function is only called for ships that are in the player's system.
 	if(ship.GetTargetSystem())
@@ -1152,10 +1231,11 @@ void AI::DoSurveillance(Ship &ship, Command &command, const list<shared_ptr<Ship
 		vector<const System *> targetSystems;
 		
 		if(cargoScan || outfitScan)
-			for(const auto &it : ships)
-				if(it->GetGovernment() != ship.GetGovernment() && it->IsTargetable()
-						&& it->GetSystem() == ship.GetSystem())
+			for(unsigned i = 0; i < ships.Size(); ++i)
+				if(ships.GetGovernment(i) != ship.GetGovernment() && ships.Is(i, ShipRegistry::TARGETABLE)
+						&& ships.GetSystem(i) == ship.GetSystem())
 				{
+					shared_ptr<Ship> it = ships.Shared(i);
 					if(Has(ship, it, ShipEvent::SCAN_CARGO) && Has(ship, it, ShipEvent::SCAN_OUTFITS))
 						continue;
 				
@@ -1195,54 +1275,62 @@ void AI::DoSurveillance(Ship &ship, Command &command, const list<shared_ptr<Ship
 
 
 
-void AI::DoCloak(Ship &ship, Command &command, const list<shared_ptr<Ship>> &ships)
+void AI::DoCloak(Ship &ship, Command &command, double nearestEnemy)
 {
-	if(ship.Attributes().Get("cloak"))
+	if(ship.Attributes().Get(CLOAK))
 	{
 		// Never cloak if it will cause you to be stranded.
-		if(ship.Attributes().Get("cloaking fuel") && !ship.Attributes().Get("ramscoop"))
+		if(ship.Attributes().Get(CLOAKING_FUEL) && !ship.Attributes().Get(RAMSCOOP))
 		{
-			double fuel = ship.Fuel() * ship.Attributes().Get("fuel capacity");
-			fuel -= ship.Attributes().Get("cloaking fuel");
+			double fuel = ship.Fuel() * ship.Attributes().Get(FUEL_CAPACITY);
+			fuel -= ship.Attributes().Get(CLOAKING_FUEL);
 			if(fuel < ship.JumpFuel())
 				return;
 		}
 		// Otherwise, always cloak if you are in imminent danger.
-		static const double MAX_RANGE = 10000.;
-		double nearestEnemy = MAX_RANGE;
-		for(const auto &other : ships)
-			if(other->GetSystem() == ship.GetSystem() && other->IsTargetable() &&
-					other->GetGovernment()->IsEnemy(ship.GetGovernment()))
-				nearestEnemy = min(nearestEnemy,
-					ship.Position().Distance(other->Position()));
-		
 		if(ship.Hull() + ship.Shields() < 1. && nearestEnemy < 2000.)
 			command |= Command::CLOAK;
 		
 		// Also cloak if there are no enemies nearby and cloaking does
 		// not cost you fuel.
-		if(nearestEnemy == MAX_RANGE && !ship.Attributes().Get("cloaking fuel"))
+		if(nearestEnemy == MAX_ENEMY_RANGE && !ship.Attributes().Get(CLOAKING_FUEL))
 			command |= Command::CLOAK;
 	}
 }
 
 
 
-void AI::DoScatter(Ship &ship, Command &command, const list<shared_ptr<Ship>> &ships)
+// Find the distance to the closest enemy of the given ship, up to a maximum
+// of MAX_ENEMY_RANGE.
+double AI::NearestEnemy(const Ship &ship, const ShipRegistry &ships)
+{
+	double nearestEnemy = MAX_ENEMY_RANGE;
+	for(unsigned i = 0; i < ships.Size(); ++i)
+		if(ships.GetSystem(i) == ship.GetSystem() && ships.Is(i, ShipRegistry::TARGETABLE) &&
+				ships.GetGovernment(i)->IsEnemy(ship.GetGovernment()))
+			nearestEnemy = min(nearestEnemy,
+				ship.Position().Distance(ships.Position(i)));
+	return nearestEnemy;
+}
+
+
+
+// Check if any ship is overlapping the given one with nearly the same movement
+// profile. If so, return the direction to turn (if thrusting) to get away from
+// it; otherwise, return 0.
+double AI::Scatter(const Ship &ship, const ShipRegistry &ships)
 {
-	if(!command.Has(Command::FORWARD))
-		return;
-	
 	double turnRate = ship.TurnRate();
 	double acceleration = ship.Acceleration();
-	for(const shared_ptr<Ship> &other : ships)
+	for(unsigned i = 0; i < ships.Size(); ++i)
 	{
-		if(other.get() == &ship)
+		const Ship *other = &ships.Get(i);
+		if(other == &ship)
 			continue;
 		
 		// Check for any ships that have nearly the same movement profile as
 		// this ship and are in nearly the same location.
-		Point offset = other->Position() - ship.Position();
+		Point offset = ships.Position(i) - ship.Position();
 		if(offset.LengthSquared() > 400.)
 			continue;
 		if(fabs(other->TurnRate() / turnRate - 1.) > .05)
@@ -1251,9 +1339,9 @@ void AI::DoScatter(Ship &ship, Command &command, const list<shared_ptr<Ship>> &s
 			continue;
 		
 		// Move away from this ship. What side of me is it on?
-		command.SetTurn(offset.Cross(ship.Facing().Unit()) > 0. ? 1. : -1.);
-		return;
+		return (offset.Cross(ship.Facing().Unit()) > 0. ? 1. : -1.);
 	}
+	return 0.;
 }
 
 
@@ -1280,10 +1368,10 @@ Point AI::StoppingPoint(const Ship &ship, bool &shouldReverse)
 	// The average term's value will be v / 2. So:
 	stopDistance += .5 * v * v / acceleration;
 	
-	if(ship.Attributes().Get("reverse thrust"))
+	if(ship.Attributes().Get(REVERSE_THRUST))
 	{
 		// Figure out your reverse thruster stopping distance:
-		double reverseAcceleration = ship.Attributes().Get("reverse thrust") / ship.Mass();
+		double reverseAcceleration = ship.Attributes().Get(REVERSE_THRUST) / ship.Mass();
 		double reverseDistance = v * (180. - degreesToTurn) / turnRate;
 		reverseDistance += .5 * v * v / reverseAcceleration;
 		
@@ -1338,7 +1426,7 @@ Point AI::TargetAim(const Ship &ship)
 
 
 // Fire whichever of the given ship's weapons can hit a hostile target.
-Command AI::AutoFire(const Ship &ship, const list<shared_ptr<Ship>> &ships, bool secondary) const
+Command AI::AutoFire(const Ship &ship, const ShipRegistry &ships, const Point &confusion, bool secondary) const
 {
 	Command command;
 	if(ship.GetPersonality().IsPacifist())
@@ -1385,14 +1473,15 @@ Command AI::AutoFire(const Ship &ship, const list<shared_ptr<Ship>> &ships, bool
 	vector<shared_ptr<const Ship>> enemies;
 	if(currentTarget)
 		enemies.push_back(currentTarget);
-	for(auto target : ships)
-		if(target->IsTargetable() && gov->IsEnemy(target->GetGovernment())
-				&& !(target->IsHyperspacing() && target->Velocity().Length() > 10.)
-				&& target->GetSystem() == ship.GetSystem()
-				&& target->Position().Distance(ship.Position()) < maxRange
-				&& target != currentTarget)
-			enemies.push_back(target);
-	
+	for(unsigned i = 0; i < ships.Size(); ++i)
+		if(ships.Is(i, ShipRegistry::TARGETABLE) && gov->IsEnemy(ships.GetGovernment(i))
+				&& !(ships.Is(i, ShipRegistry::HYPERSPACING) && ships.Velocity(i).Length() > 10.)
+				&& ships.GetSystem(i) == ship.GetSystem()
+				&& ships.Position(i).Distance(ship.Position()) < maxRange
+				&& &ships.Get(i) != currentTarget.get())
+			enemies.push_back(ships.Shared(i));
+	
+	vector<AimedWeapon> aimed;
 	for(const Armament::Weapon &weapon : ship.Weapons())
 	{
 		++index;
@@ -1409,7 +1498,7 @@ Command AI::AutoFire(const Ship &ship, const list<shared_ptr<Ship>> &ships, bool
 		// fuel that you cannot leave the system if necessary.
 		if(weapon.GetOutfit()->FiringFuel())
 		{
-			double fuel = ship.Fuel() * ship.Attributes().Get("fuel capacity");
+			double fuel = ship.Fuel() * ship.Attributes().Get(FUEL_CAPACITY);
 			fuel -= weapon.GetOutfit()->FiringFuel();
 			// If the ship is not ever leaving this system, it does not need to
 			// reserve any fuel.
@@ -1420,7 +1509,7 @@ Command AI::AutoFire(const Ship &ship, const list<shared_ptr<Ship>> &ships, bool
 		// Figure out where this weapon will fire from, but add some randomness
 		// depending on how accurate this ship's pilot is.
 		Point start = ship.Position() + ship.Facing().Rotate(weapon.GetPoint());
-		start += ship.GetPersonality().Confusion();
+		start += confusion;
 		
 		const Outfit *outfit = weapon.GetOutfit();
 		double vp = outfit->Velocity();
@@ -1465,32 +1554,56 @@ Command AI::AutoFire(const Ship &ship, const list<shared_ptr<Ship>> &ships, bool
 		if(weapon.IsHoming())
 			continue;
 		
-		for(const shared_ptr<const Ship> &target : enemies)
+		// Get the velocity of the projectiles this weapon fires.
+		Point velocity = (ship.Facing() + weapon.GetAngle()).Unit() * vp;
+		aimed.push_back({index, start, velocity, lifetime});
+	}
+	
+	// Check all the remaining weapons against one enemy at a time, so that the
+	// enemy's mask can test them all at once. Once a weapon is found to hit an
+	// enemy, it does not need to be checked against any others.
+	vector<Point> sA;
+	vector<Point> vA;
+	vector<double> result;
+	for(const shared_ptr<const Ship> &target : enemies)
+	{
+		if(aimed.empty())
+			break;
+		
+		// Don't shoot ships we want to plunder.
+		bool hasBoarded = Has(ship, target, ShipEvent::BOARD);
+		if(target->IsDisabled() && spareDisabled && !hasBoarded)
+			if(!(ship.IsYours() && target == sharedTarget.lock() && killDisabledSharedTarget))
+				continue;
+		
+		sA.clear();
+		vA.clear();
+		Point v = target->Velocity() - ship.Velocity();
+		for(const AimedWeapon &weapon : aimed)
 		{
-			// Don't shoot ships we want to plunder.
-			bool hasBoarded = Has(ship, target, ShipEvent::BOARD);
-			if(target->IsDisabled() && spareDisabled && !hasBoarded)
-				if(!(ship.IsYours() && target == sharedTarget.lock() && killDisabledSharedTarget))
-					continue;
-			
-			Point p = target->Position() - start;
-			Point v = target->Velocity() - ship.Velocity();
+			Point p = target->Position() - weapon.start;
 			// By the time this action is performed, the ships will have moved
 			// forward one time step.
 			p += v;
+			sA.push_back(-p);
 			
-			// Get the vector the weapon will travel along.
-			v = (ship.Facing() + weapon.GetAngle()).Unit() * vp - v;
-			// Extrapolate over the lifetime of the projectile.
-			v *= lifetime;
-			
-			const Mask &mask = target->GetSprite().GetMask(step);
-			if(mask.Collide(-p, v, target->Facing()) < 1.)
-			{
-				command.SetFire(index);
-				break;
-			}
+			// Get the vector the weapon will travel along, extrapolated over
+			// the lifetime of the projectile.
+			vA.push_back((weapon.velocity - v) * weapon.lifetime);
+		}
+		result.resize(aimed.size());
+		const Mask &mask = target->GetSprite().GetMask(step);
+		mask.Collide(sA.data(), vA.data(), aimed.size(), target->Facing(), result.data());
+		
+		unsigned remaining = 0;
+		for(unsigned i = 0; i < aimed.size(); ++i)
+		{
+			if(result[i] < 1.)
+				command.SetFire(aimed[i].index);
+			else
+				aimed[remaining++] = aimed[i];
 		}
+		aimed.resize(remaining);
 	}
 	
 	return command;
@@ -1498,7 +1611,7 @@ Command AI::AutoFire(const Ship &ship, const list<shared_ptr<Ship>> &ships, bool
 
 
 
-void AI::MovePlayer(Ship &ship, const PlayerInfo &player, const list<shared_ptr<Ship>> &ships)
+void AI::MovePlayer(Ship &ship, const PlayerInfo &player, const ShipRegistry &ships)
 {
 	Command command;
 	
@@ -1536,9 +1649,10 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, const list<shared_ptr<
 	{
 		double closest = numeric_limits<double>::infinity();
 		int closeState = 0;
-		for(const shared_ptr<Ship> &other : ships)
-			if(other.get() != &ship && other->IsTargetable())
+		for(unsigned i = 0; i < ships.Size(); ++i)
+			if(&ships.Get(i) != &ship && ships.Is(i, ShipRegistry::TARGETABLE))
 			{
+				shared_ptr<Ship> other = ships.Shared(i);
 				// Sort ships into one of three priority states:
 				// 0 = friendly, 1 = disabled enemy, 2 = active enemy.
 				int state = other->GetGovernment()->IsEnemy(ship.GetGovernment());
@@ -1565,8 +1679,9 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, const list<shared_ptr<
 	{
 		shared_ptr<const Ship> target = ship.GetTargetShip();
 		bool selectNext = !target || !target->IsTargetable();
-		for(const shared_ptr<Ship> &other : ships)
+		for(unsigned i = 0; i < ships.Size(); ++i)
 		{
+			shared_ptr<Ship> other = ships.Shared(i);
 			bool isPlayer = other->GetGovernment()->IsPlayer() || other->GetPersonality().IsEscort();
 			if(other == target)
 				selectNext = true;
@@ -1591,9 +1706,10 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, const list<shared_ptr<
 			double closest = numeric_limits<double>::infinity();
 			bool foundEnemy = false;
 			bool foundAnything = false;
-			for(const shared_ptr<Ship> &other : ships)
-				if(CanBoard(ship, *other))
+			for(unsigned i = 0; i < ships.Size(); ++i)
+				if(CanBoard(ship, ships.Get(i)))
 				{
+					shared_ptr<Ship> other = ships.Shared(i);
 					if(shift && !other->IsYours())
 						continue;
 					
@@ -1718,7 +1834,7 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, const list<shared_ptr<
 		if(!ship.GetTargetSystem())
 		{
 			double bestMatch = -2.;
-			const auto &links = (ship.Attributes().Get("jump drive") ?
+			const auto &links = (ship.Attributes().Get(JUMP_DRIVE) ?
 				ship.GetSystem()->Neighbors() : ship.GetSystem()->Links());
 			for(const System *link : links)
 			{
@@ -1739,7 +1855,7 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, const list<shared_ptr<
 		&& !(keyStuck | keyHeld).Has(Command::LAND | Command::JUMP | Command::BOARD)
 		&& (!ship.GetTargetShip() || ship.GetTargetShip()->GetGovernment()->IsEnemy());
 	if(hasGuns)
-		command |= AutoFire(ship, ships, false);
+		command |= AutoFire(ship, ships, ship.GetPersonality().Confusion(), false);
 	hasGuns |= keyHeld.Has(Command::PRIMARY);
 	if(keyHeld)
 	{
@@ -1747,7 +1863,7 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, const list<shared_ptr<
 			command.SetTurn(keyHeld.Has(Command::RIGHT) - keyHeld.Has(Command::LEFT));
 		else if(keyHeld.Has(Command::BACK))
 		{
-			if(ship.Attributes().Get("reverse thrust"))
+			if(ship.Attributes().Get(REVERSE_THRUST))
 				command |= Command::BACK;
 			else
 				command.SetTurn(TurnBackward(ship));
@@ -1810,7 +1926,7 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, const list<shared_ptr<
 	}
 	else if(keyStuck.Has(Command::JUMP) && ship.GetTargetSystem())
 	{
-		if(!ship.Attributes().Get("hyperdrive") && !ship.Attributes().Get("jump drive"))
+		if(!ship.Attributes().Get(HYPERDRIVE) && !ship.Attributes().Get(JUMP_DRIVE))
 		{
 			Messages::Add("You do not have a hyperdrive installed.");
 			keyStuck.Clear();
@@ -14,17 +14,20 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #define AI_H_
 
 #include "Command.h"
+#include "Point.h"
+#include "ThreadPool.h"
 
 #include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
+#include <vector>
 
 class Government;
-class Point;
 class Ship;
-class ShipEvent;
 class PlayerInfo;
+class ShipEvent;
+class ShipRegistry;
 
 
 
@@ -39,12 +42,12 @@ public:
 	void UpdateKeys(PlayerInfo &player, Command &clickCommands, bool isActive);
 	void UpdateEvents(const std::list<ShipEvent> &events);
 	void Clean();
-	void Step(const std::list<std::shared_ptr<Ship>> &ships, const PlayerInfo &player);
+	void Step(const ShipRegistry &ships, const PlayerInfo &player);
 	
 	
 private:
 	// Pick a new target for the given ship.
-	std::shared_ptr<Ship> FindTarget(const Ship &ship, const std::list<std::shared_ptr<Ship>> &ships) const;
+	std::shared_ptr<Ship> FindTarget(const Ship &ship, const ShipRegistry &ships) const;
 	
 	void MoveIndependent(Ship &ship, Command &command) const;
 	static void MoveEscort(Ship &ship, Command &command);
@@ -58,9 +61,10 @@ private:
 	static void PrepareForHyperspace(Ship &ship, Command &command);
 	static void CircleAround(Ship &ship, Command &command, const Ship &target);
 	static void Attack(Ship &ship, Command &command, const Ship &target);
-	void DoSurveillance(Ship &ship, Command &command, const std::list<std::shared_ptr<Ship>> &ships) const;
-	static void DoCloak(Ship &ship, Command &command, const std::list<std::shared_ptr<Ship>> &ships);
-	static void DoScatter(Ship &ship, Command &command, const std::list<std::shared_ptr<Ship>> &ships);
+	void DoSurveillance(Ship &ship, Command &command, const ShipRegistry &ships) const;
+	static void DoCloak(Ship &ship, Command &command, double nearestEnemy);
+	static double NearestEnemy(const Ship &ship, const ShipRegistry &ships);
+	static double Scatter(const Ship &ship, const ShipRegistry &ships);
 	
 	static Point StoppingPoint(const Ship &ship, bool &shouldReverse);
 	// Get a vector giving the direction this ship should aim in in order to do
@@ -68,16 +72,38 @@ private:
 	// non-homing weapons. If the ship has no non-homing weapons, this just
 	// returns the direction to the target.
 	static Point TargetAim(const Ship &ship);
-	// Fire whichever of the given ship's weapons can hit a hostile target.
-	// Return a bitmask giving the weapons to fire.
-	Command AutoFire(const Ship &ship, const std::list<std::shared_ptr<Ship>> &ships, bool secondary = true) const;
+	// Fire whichever of the given ship's weapons can hit a hostile target,
+	// given how far off the pilot's aim is. Return a bitmask giving the
+	// weapons to fire.
+	Command AutoFire(const Ship &ship, const ShipRegistry &ships, const Point &confusion, bool secondary = true) const;
 	
-	void MovePlayer(Ship &ship, const PlayerInfo &player, const std::list<std::shared_ptr<Ship>> &ships);
+	void MovePlayer(Ship &ship, const PlayerInfo &player, const ShipRegistry &ships);
 	
 	bool Has(const Ship &ship, const std::weak_ptr<const Ship> &other, int type) const;
 	bool Has(const Government *government, const std::weak_ptr<const Ship> &other, int type) const;
 	
 	
+private:
+	// The results of the decisions that are made in parallel for each ship.
+	class Decision {
+	public:
+		Decision(const std::shared_ptr<Ship> &ship, const Command &command, bool isPresent, bool isStranded)
+			: ship(ship), command(command), isPresent(isPresent), isStranded(isStranded) {}
+		
+		std::shared_ptr<Ship> ship;
+		Command command;
+		bool isPresent;
+		bool isStranded;
+		bool findTarget = false;
+		Point confusion;
+		
+		Command autoFire;
+		std::shared_ptr<Ship> target;
+		double nearestEnemy = 0.;
+		double scatter = 0.;
+	};
+	
+	
 private:
 	int step = 0;
 	
@@ -102,10 +128,14 @@ private:
 	std::map<const Government *, std::map<std::weak_ptr<const Ship>, int, Comp>> governmentActions;
 	std::map<std::weak_ptr<const Ship>, int, Comp> playerActions;
 	
-	std::map<const Ship *, int64_t> shipStrength;
+	// The strength of each ship's allies near it, by its index in the registry.
+	std::vector<int64_t> shipStrength;
 	
 	std::map<const Government *, int64_t> enemyStrength;
 	std::map<const Government *, int64_t> allyStrength;
+	
+	std::vector<Decision> decisions;
+	ThreadPool pool;
 };
 
 
@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "pi.h"
 #include "Random.h"
+#include "RandomStream.h"
 
 #include <algorithm>
 #include <cmath>
@@ -53,6 +54,14 @@ Angle Angle::Random(double range)
 
 
 
+// Get a random angle using the given stream of random numbers.
+Angle Angle::Random(RandomStream &random)
+{
+	return Angle(static_cast<int32_t>(random.Int(STEPS)));
+}
+
+
+
 Angle::Angle()
 	: angle(0)
 {
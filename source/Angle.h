@@ -17,6 +17,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include <cstdint>
 
+class RandomStream;
+
 
 
 // Represents an angle, in degrees. Angles are in "clock" orientation rather
@@ -28,6 +30,8 @@ public:
 	// Return a random angle up to the given amount (between 0 and 360).
 	static Angle Random();
 	static Angle Random(double range);
+	// Get a random angle using the given stream of random numbers.
+	static Angle Random(RandomStream &random);
 	
 	
 public:
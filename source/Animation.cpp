@@ -54,8 +54,7 @@ void Animation::Load(const DataNode &node)
 {
 	if(node.Size() < 2)
 		return;
-	spriteName = node.Token(1);
-	sprite = SpriteSet::Get(spriteName);
+	sprite = SpriteSet::Get(node.Token(1));
 	
 	// The only time the animation does not start on a specific frame is if no
 	// start frame is specified and it repeats. Since a frame that does not
@@ -94,7 +93,7 @@ void Animation::Load(const DataNode &node)
 // those will not generally apply to a ship sprite.
 void Animation::Save(DataWriter &out) const
 {
-	out.Write("sprite", spriteName);
+	out.Write("sprite", sprite ? sprite->Name() : "");
 	out.BeginChild();
 	{
 		if(frameRate != 1.)
@@ -14,7 +14,6 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #define ANIMATION_H_
 
 #include <cstdint>
-#include <string>
 
 class DataNode;
 class DataWriter;
@@ -79,7 +78,6 @@ private:
 	
 private:
 	const Sprite *sprite;
-	std::string spriteName;
 	int swizzle;
 	
 	float frameRate;
@@ -115,7 +115,7 @@ void Armament::Weapon::Step()
 // Fire this weapon. If it is a turret, it automatically points toward
 // the given ship's target. If the weapon requires ammunition, it will
 // be subtracted from the given ship.
-void Armament::Weapon::Fire(Ship &ship, list<Projectile> &projectiles, list<Effect> &effects)
+void Armament::Weapon::Fire(Ship &ship, vector<Projectile> &projectiles, vector<Effect> &effects)
 {
 	// Since this is only called internally by Armament (no one else has non-
 	// const access), assume Armament checked that this is a valid call.
@@ -169,7 +169,7 @@ void Armament::Weapon::Fire(Ship &ship, list<Projectile> &projectiles, list<Effe
 
 
 // Fire an anti-missile. Returns true if the missile should be killed.
-bool Armament::Weapon::FireAntiMissile(Ship &ship, const Projectile &projectile, list<Effect> &effects)
+bool Armament::Weapon::FireAntiMissile(Ship &ship, const Projectile &projectile, vector<Effect> &effects)
 {
 	int strength = outfit->AntiMissile();
 	if(!strength)
@@ -370,7 +370,7 @@ int Armament::TurretCount() const
 
 // Fire the given weapon, if it is ready. If it did not fire because it is
 // not ready, return false.
-void Armament::Fire(int index, Ship &ship, list<Projectile> &projectiles, list<Effect> &effects)
+void Armament::Fire(int index, Ship &ship, vector<Projectile> &projectiles, vector<Effect> &effects)
 {
 	if(static_cast<unsigned>(index) >= weapons.size() || !weapons[index].IsReady())
 		return;
@@ -391,7 +391,7 @@ void Armament::Fire(int index, Ship &ship, list<Projectile> &projectiles, list<E
 
 
 
-bool Armament::FireAntiMissile(int index, Ship &ship, const Projectile &projectile, list<Effect> &effects)
+bool Armament::FireAntiMissile(int index, Ship &ship, const Projectile &projectile, vector<Effect> &effects)
 {
 	if(static_cast<unsigned>(index) >= weapons.size() || !weapons[index].IsReady())
 		return false;
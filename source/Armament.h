@@ -17,7 +17,6 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Point.h"
 
 #include <map>
-#include <list>
 #include <vector>
 
 class Effect;
@@ -63,9 +62,9 @@ public:
 		// Fire this weapon. If it is a turret, it automatically points toward
 		// the given ship's target. If the weapon requires ammunition, it will
 		// be subtracted from the given ship.
-		void Fire(Ship &ship, std::list<Projectile> &projectiles, std::list<Effect> &effects);
+		void Fire(Ship &ship, std::vector<Projectile> &projectiles, std::vector<Effect> &effects);
 		// Fire an anti-missile. Returns true if the missile should be killed.
-		bool FireAntiMissile(Ship &ship, const Projectile &projectile, std::list<Effect> &effects);
+		bool FireAntiMissile(Ship &ship, const Projectile &projectile, std::vector<Effect> &effects);
 		
 		// Install a weapon here (assuming it is empty). This is only for
 		// Armament to call internally.
@@ -111,9 +110,9 @@ public:
 	
 	// Fire the given weapon, if it is ready. If it did not fire because it is
 	// not ready, return false.
-	void Fire(int index, Ship &ship, std::list<Projectile> &projectiles, std::list<Effect> &effects);
+	void Fire(int index, Ship &ship, std::vector<Projectile> &projectiles, std::vector<Effect> &effects);
 	// Fire the given anti-missile system.
-	bool FireAntiMissile(int index, Ship &ship, const Projectile &projectile, std::list<Effect> &effects);
+	bool FireAntiMissile(int index, Ship &ship, const Projectile &projectile, std::vector<Effect> &effects);
 	
 	// Update the reload counters.
 	void Step(const Ship &ship);
@@ -17,7 +17,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Mask.h"
 #include "Projectile.h"
 #include "Random.h"
+#include "Sprite.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
@@ -26,6 +28,23 @@ using namespace std;
 namespace {
 	static const int WRAP_MASK = 4095;
 	static const double WRAP = (WRAP_MASK + 1);
+	
+	// The grid is 16 x 16 cells, each 256 pixels wide.
+	static const int CELL_SHIFT = 8;
+	static const double CELL_SIZE = (1 << CELL_SHIFT);
+	static const int GRID_SIZE = (WRAP_MASK + 1) >> CELL_SHIFT;
+	static const int GRID_MASK = GRID_SIZE - 1;
+	
+	// Get the (unwrapped) column or row of the grid the given coordinate is in.
+	int Cell(double value)
+	{
+		return static_cast<int>(floor(value / CELL_SIZE));
+	}
+	
+	int Cell(const Point &point)
+	{
+		return (Cell(point.Y()) & GRID_MASK) * GRID_SIZE + (Cell(point.X()) & GRID_MASK);
+	}
 }
 
 
@@ -39,15 +58,25 @@ AsteroidField::AsteroidField()
 void AsteroidField::Clear()
 {
 	asteroids.clear();
+	radius = 0.;
+	unchecked = false;
+	Rebuild();
 }
 
 
 
 void AsteroidField::Add(const string &name, int count, double energy)
 {
+	// Give each group of asteroids its own stream of random numbers.
+	RandomStream random = Random::Stream();
 	const Sprite *sprite = SpriteSet::Get("asteroid/" + name + "/spin");
 	for(int i = 0; i < count; ++i)
-		asteroids.emplace_back(sprite, energy);
+		asteroids.emplace_back(sprite, energy, random);
+	
+	for(int i = 0; i < sprite->Frames(); ++i)
+		radius = max(radius, sprite->GetMask(i).Radius());
+	unchecked |= (count > 0);
+	Rebuild();
 }
 
 
@@ -56,6 +85,8 @@ void AsteroidField::Step()
 {
 	for(Asteroid &asteroid : asteroids)
 		asteroid.Step();
+	
+	Rebuild();
 }
 
 
@@ -71,31 +102,92 @@ void AsteroidField::Draw(DrawList &draw, const Point &center, const Point &cente
 double AsteroidField::Collide(const Projectile &projectile, int step, Point *hitVelocity) const
 {
 	double distance = 1.;
-	for(const Asteroid &asteroid : asteroids)
+	unsigned closest = asteroids.size();
+	auto check = [&](unsigned index)
 	{
-		double thisDistance = asteroid.Collide(projectile, step);
-		if(thisDistance < distance)
+		double thisDistance = asteroids[index].Collide(projectile, step);
+		// If two asteroids are hit at the same distance, the one that comes
+		// first in the list is the one that counts.
+		if(thisDistance < distance || (thisDistance == distance && index < closest))
 		{
 			distance = thisDistance;
-			if(hitVelocity)
-				*hitVelocity = asteroid.Velocity();
+			closest = index;
 		}
+	};
+	
+	// Each asteroid's animation picks a random starting frame the first time
+	// its mask is used. The first time new asteroids are checked, check all of
+	// them, so the sequence of random numbers does not depend on which
+	// asteroids happen to be near a projectile.
+	if(unchecked)
+	{
+		unchecked = false;
+		for(unsigned i = 0; i < asteroids.size(); ++i)
+			check(i);
+	}
+	else
+	{
+		// Only asteroids whose centers are within the given radius of the
+		// projectile's path can possibly be hit by it. Find all the cells that
+		// are within that distance of the path. If the path is long enough to
+		// span the whole grid, no cell should be checked more than once.
+		Point start = projectile.Position();
+		Point end = start + projectile.Velocity();
+		int minX = Cell(min(start.X(), end.X()) - radius);
+		int minY = Cell(min(start.Y(), end.Y()) - radius);
+		int width = min(Cell(max(start.X(), end.X()) + radius) - minX + 1, GRID_SIZE);
+		int height = min(Cell(max(start.Y(), end.Y()) + radius) - minY + 1, GRID_SIZE);
+		
+		for(int y = 0; y < height; ++y)
+			for(int x = 0; x < width; ++x)
+			{
+				int cell = ((minY + y) & GRID_MASK) * GRID_SIZE + ((minX + x) & GRID_MASK);
+				for(unsigned i = cellBegin[cell]; i < cellBegin[cell + 1]; ++i)
+					check(cellAsteroids[i]);
+			}
 	}
 	
+	if(hitVelocity && distance < 1.)
+		*hitVelocity = asteroids[closest].Velocity();
+	
 	return distance;
 }
 
 
 
-AsteroidField::Asteroid::Asteroid(const Sprite *sprite, double energy)
-	: animation(sprite, Random::Real() * 4. * energy + 5.)
+// Sort the asteroids into the cells of the grid.
+void AsteroidField::Rebuild()
 {
-	location = Point(Random::Int() & WRAP_MASK, Random::Int() & WRAP_MASK);
+	// Count how many asteroids are in each cell, then turn that into the index
+	// where each cell's list starts.
+	cellBegin.assign(GRID_SIZE * GRID_SIZE + 1, 0);
+	for(const Asteroid &asteroid : asteroids)
+		++cellBegin[Cell(asteroid.Position()) + 1];
+	for(unsigned i = 1; i < cellBegin.size(); ++i)
+		cellBegin[i] += cellBegin[i - 1];
 	
-	angle = Angle::Random(360.);
-	spin = Angle((Random::Real() * 2. - 1.) * energy);
+	// Place each asteroid in its cell's list, advancing that cell's start index
+	// as it fills up. Afterwards, each cell's start index is where the next
+	// cell starts, so shift them all over by one.
+	cellAsteroids.resize(asteroids.size());
+	for(unsigned i = 0; i < asteroids.size(); ++i)
+		cellAsteroids[cellBegin[Cell(asteroids[i].Position())]++] = i;
+	for(unsigned i = cellBegin.size() - 1; i; --i)
+		cellBegin[i] = cellBegin[i - 1];
+	cellBegin[0] = 0;
+}
+
+
+
+AsteroidField::Asteroid::Asteroid(const Sprite *sprite, double energy, RandomStream &random)
+	: animation(sprite, random.Real() * 4. * energy + 5.)
+{
+	location = Point(random.Int() & WRAP_MASK, random.Int() & WRAP_MASK);
 	
-	velocity = angle.Unit() * Random::Real() * energy;
+	angle = Angle::Random(random);
+	spin = Angle((random.Real() * 2. - 1.) * energy);
+	
+	velocity = angle.Unit() * random.Real() * energy;
 }
 
 
@@ -138,6 +230,13 @@ double AsteroidField::Asteroid::Collide(const Projectile &projectile, int step)
 
 
 
+Point AsteroidField::Asteroid::Position() const
+{
+	return location;
+}
+
+
+
 Point AsteroidField::Asteroid::Velocity() const
 {
 	return velocity;
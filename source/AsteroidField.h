@@ -16,6 +16,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Angle.h"
 #include "Animation.h"
 #include "Point.h"
+#include "RandomStream.h"
 
 #include <string>
 #include <vector>
@@ -33,7 +34,8 @@ class Sprite;
 // player can see, but that means that missiles are not in danger of hitting an
 // asteroid unless they are on screen, and also causes trouble if the screen is
 // resized on the fly. Asteroids never change direction or speed, even if they
-// are hit by a projectile.
+// are hit by a projectile. To find which asteroids a projectile might hit, the
+// field is divided into a grid of cells that wraps around the same way.
 class AsteroidField {
 public:
 	AsteroidField();
@@ -46,15 +48,21 @@ public:
 	double Collide(const Projectile &projectile, int step, Point *hitVelocity = nullptr) const;
 	
 	
+private:
+	// Sort the asteroids into the cells of the grid.
+	void Rebuild();
+	
+	
 private:
 	class Asteroid {
 	public:
-		Asteroid(const Sprite *sprite, double energy);
+		Asteroid(const Sprite *sprite, double energy, RandomStream &random);
 		
 		void Step();
 		void Draw(DrawList &draw, const Point &center, const Point &centerVelocity) const;
 		double Collide(const Projectile &projectile, int step) const;
 		
+		Point Position() const;
 		Point Velocity() const;
 		
 	private:
@@ -70,6 +78,14 @@ private:
 	
 private:
 	std::vector<Asteroid> asteroids;
+	// The farthest any asteroid's outline extends from its center.
+	double radius = 0.;
+	// The indices of the asteroids whose centers are in each cell of the grid,
+	// stored contiguously with the start of each cell's range in cellBegin.
+	std::vector<unsigned> cellBegin;
+	std::vector<unsigned> cellAsteroids;
+	// Whether any asteroids have not been checked for collisions yet.
+	mutable bool unchecked = false;
 };
 
 
@@ -0,0 +1,473 @@
+/* Benchmark.cpp
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "Benchmark.h"
+
+#include "Engine.h"
+#include "Files.h"
+#include "Fleet.h"
+#include "FrameTimer.h"
+#include "GameData.h"
+#include "Mask.h"
+#include "PlayerInfo.h"
+#include "Random.h"
+#include "Ship.h"
+#include "ShipEvent.h"
+#include "Sprite.h"
+#include "SpriteQueue.h"
+#include "StellarObject.h"
+#include "System.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// How many copies of each of the system's fleets to start out with.
+	const int FLEET_COPIES = 2;
+	
+	const char *PHASE_NAMES[Engine::PHASE_COUNT + 1] = {
+		"ai", "movement", "firing", "collision", "drawing", "total"};
+	
+	const char *EVENT_NAMES[] = {
+		"assist", "scan cargo", "scan outfits", "provoke", "disable",
+		"board", "capture", "destroy", "atrocity", "jump"};
+	const int EVENT_TYPES = sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]);
+	
+	// Fold the given bytes into a 64-bit FNV-1a hash.
+	void Hash(uint64_t &hash, const void *data, size_t size)
+	{
+		const unsigned char *it = reinterpret_cast<const unsigned char *>(data);
+		for(const unsigned char *end = it + size; it != end; ++it)
+			hash = (hash ^ *it) * 1099511628211ull;
+	}
+	
+	// Get the given percentile of a sorted list of times, in milliseconds.
+	double Percentile(const vector<double> &sorted, double fraction)
+	{
+		if(sorted.empty())
+			return 0.;
+		size_t index = min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+		return sorted[index] * 1000.;
+	}
+	
+	// How many segments share each facing in the mask benchmark, and how many
+	// of those groups to test against each mask.
+	const int MASK_BATCH = 8;
+	const int MASK_BATCHES = 32;
+	
+	// The mask tests exactly as they were written before the outline was also
+	// stored in vectorizable form, to check that the results are unchanged.
+	bool ReferenceContains(const vector<Point> &outline, Point point)
+	{
+		int intersections = 0;
+		Point prev = outline.back();
+		for(const Point &next : outline)
+		{
+			if(prev.X() != next.X())
+				if((prev.X() <= point.X()) == (point.X() < next.X()))
+				{
+					double y = prev.Y() + (next.Y() - prev.Y()) *
+						(point.X() - prev.X()) / (next.X() - prev.X());
+					intersections += (y >= point.Y());
+				}
+			prev = next;
+		}
+		return (intersections & 1);
+	}
+	
+	
+	double ReferenceCollide(const Mask &mask, Point sA, Point vA, Angle facing)
+	{
+		const vector<Point> &outline = mask.Outline();
+		double distance = sA.Length();
+		if(outline.empty() || distance > mask.Radius() + vA.Length())
+			return 1.;
+		
+		sA = (-facing).Rotate(sA);
+		vA = (-facing).Rotate(vA);
+		if(distance <= mask.Radius() && ReferenceContains(outline, sA))
+			return 0.;
+		
+		double closest = 1.;
+		Point prev = outline.back();
+		for(const Point &next : outline)
+		{
+			Point vB = next - prev;
+			double cross = vB.Cross(vA);
+			if(cross > 0.)
+			{
+				Point vS = prev - sA;
+				double uB = vA.Cross(vS);
+				double uA = vB.Cross(vS);
+				if((uB >= 0.) & (uB < cross) & (uA >= 0.))
+					closest = min(closest, uA / cross);
+			}
+			prev = next;
+		}
+		return closest;
+	}
+	
+	
+	bool ReferenceContains(const Mask &mask, Point point, Angle facing)
+	{
+		if(point.Length() > mask.Radius())
+			return false;
+		return ReferenceContains(mask.Outline(), (-facing).Rotate(point));
+	}
+	
+	
+	double ReferenceRange(const Mask &mask, Point point, Angle facing)
+	{
+		double range = numeric_limits<double>::infinity();
+		point = (-facing).Rotate(point);
+		if(ReferenceContains(mask.Outline(), point))
+			return 0.;
+		
+		for(const Point &p : mask.Outline())
+			range = min(range, p.Distance(point));
+		return range;
+	}
+}
+
+
+
+// Run the benchmark described by the given command line arguments:
+// --benchmark <system> [<steps> [<seed>]]
+// The return value is the exit code for the program.
+int Benchmark::Run(const char * const *argv)
+{
+	string systemName;
+	int steps = 3600;
+	uint64_t seed = 0;
+	for(const char * const *it = argv + 1; *it; ++it)
+		if(string(*it) == "--benchmark")
+		{
+			if(it[1] && it[1][0] != '-')
+				systemName = *++it;
+			if(it[1] && it[1][0] != '-')
+				steps = max(1, atoi(*++it));
+			if(it[1] && it[1][0] != '-')
+				seed = strtoull(*++it, nullptr, 10);
+			break;
+		}
+	if(systemName.empty())
+	{
+		cerr << "Usage: --benchmark <system> [<steps> [<seed>]]" << endl;
+		return 1;
+	}
+	
+	// Load the game data. In benchmark mode, no sprites are uploaded to OpenGL.
+	GameData::BeginLoad(argv);
+	GameData::FinishLoading();
+	
+	if(!GameData::Systems().Has(systemName))
+	{
+		cerr << "There is no system named \"" << systemName << "\"." << endl;
+		return 1;
+	}
+	const System *system = GameData::Systems().Get(systemName);
+	const Planet *planet = nullptr;
+	for(const StellarObject &object : system->Objects())
+		if(object.GetPlanet())
+		{
+			planet = object.GetPlanet();
+			break;
+		}
+	if(!planet)
+	{
+		cerr << "The benchmark system must have a planet to take off from." << endl;
+		return 1;
+	}
+	if(!GameData::Ships().Has("Shuttle"))
+	{
+		cerr << "The benchmark requires the \"Shuttle\" ship model." << endl;
+		return 1;
+	}
+	
+	// Set up the scenario. Creating a new pilot seeds the random number
+	// generator with the current time, so only seed it after that.
+	PlayerInfo player;
+	player.New();
+	Random::Seed(seed);
+	player.SetSystem(system);
+	player.SetPlanet(planet);
+	const Ship *model = GameData::Ships().Get("Shuttle");
+	player.Accounts().AddCredits(model->Cost());
+	player.BuyShip(model, "Benchmark");
+	
+	Engine engine(player);
+	engine.Place();
+	for(int i = 0; i < FLEET_COPIES; ++i)
+		for(const System::FleetProbability &fleet : system->Fleets())
+			engine.AddFleet(*fleet.Get());
+	
+	// Run the simulation, keeping track of how long each phase of each step
+	// took and of everything that happened.
+	vector<double> phaseTimes;
+	vector<vector<double>> samples(Engine::PHASE_COUNT + 1);
+	for(vector<double> &times : samples)
+		times.reserve(steps);
+	int eventCounts[EVENT_TYPES] = {};
+	uint64_t checksum = 14695981039346656037ull;
+	for(int step = 0; step <= steps; ++step)
+	{
+		// Handle the events from the previous step, exactly as if the game was
+		// being played without any input from the player.
+		engine.Step(false);
+		for(const ShipEvent &event : engine.Events())
+		{
+			int type = event.Type();
+			for(int i = 0; i < EVENT_TYPES; ++i)
+				eventCounts[i] += ((type >> i) & 1);
+			
+			Hash(checksum, &step, sizeof(step));
+			Hash(checksum, &type, sizeof(type));
+			if(event.Target())
+			{
+				const string &name = event.Target()->Name();
+				Hash(checksum, name.data(), name.length());
+			}
+		}
+		if(step == steps)
+			break;
+		
+		FrameTimer timer;
+		engine.StepHeadless(phaseTimes);
+		double total = timer.Time();
+		
+		for(int i = 0; i < Engine::PHASE_COUNT; ++i)
+			samples[i].push_back(phaseTimes[i]);
+		samples.back().push_back(total);
+	}
+	const Ship *flagship = player.Flagship();
+	if(flagship)
+	{
+		double x = flagship->Position().X();
+		double y = flagship->Position().Y();
+		Hash(checksum, &x, sizeof(x));
+		Hash(checksum, &y, sizeof(y));
+	}
+	
+	// Report the results.
+	cout << "Benchmark: " << steps << " steps in " << system->Name()
+		<< " (random seed " << seed << ")." << endl;
+	cout << endl;
+	cout << setw(12) << left << "time (ms)" << right
+		<< setw(10) << "median" << setw(10) << "90%" << setw(10) << "99%"
+		<< setw(10) << "max" << setw(10) << "mean" << endl;
+	cout << fixed << setprecision(3);
+	for(unsigned i = 0; i < samples.size(); ++i)
+	{
+		vector<double> &times = samples[i];
+		double sum = 0.;
+		for(double time : times)
+			sum += time;
+		sort(times.begin(), times.end());
+		
+		cout << setw(12) << left << PHASE_NAMES[i] << right
+			<< setw(10) << Percentile(times, .5)
+			<< setw(10) << Percentile(times, .9)
+			<< setw(10) << Percentile(times, .99)
+			<< setw(10) << Percentile(times, 1.)
+			<< setw(10) << (times.empty() ? 0. : 1000. * sum / times.size()) << endl;
+	}
+	cout << endl;
+	
+	// Everything below here depends only on the scenario and the random seed.
+	cout << "Events:";
+	for(int i = 0; i < EVENT_TYPES; ++i)
+		cout << (i ? ", " : " ") << eventCounts[i] << " " << EVENT_NAMES[i];
+	cout << endl;
+	cout << "Checksum: " << hex << setw(16) << setfill('0') << checksum << endl;
+	
+	return 0;
+}
+
+
+
+// Time the collision mask tests on the outlines of every ship sprite:
+// --benchmark-masks [<repeats>]
+int Benchmark::RunMasks(const char * const *argv)
+{
+	int repeats = 20;
+	for(const char * const *it = argv + 1; *it; ++it)
+		if(string(*it) == "--benchmark-masks")
+		{
+			if(it[1] && it[1][0] != '-')
+				repeats = max(1, atoi(*++it));
+			break;
+		}
+	
+	GameData::BeginLoad(argv);
+	GameData::FinishLoading();
+	
+	// Gather every frame of every ship sprite. Many ships share a sprite.
+	set<const Sprite *> sprites;
+	for(const auto &it : GameData::Ships())
+		if(it.second.GetSprite().GetSprite())
+			sprites.insert(it.second.GetSprite().GetSprite());
+	vector<const Mask *> masks;
+	size_t vertices = 0;
+	for(const Sprite *sprite : sprites)
+		for(int i = 0; i < sprite->Frames(); ++i)
+			if(sprite->GetMask(i).IsLoaded())
+			{
+				masks.push_back(&sprite->GetMask(i));
+				vertices += masks.back()->Outline().size();
+			}
+	if(masks.empty())
+	{
+		cerr << "No ship collision masks were loaded." << endl;
+		return 1;
+	}
+	
+	// Pick random segments around each mask, in groups that share a facing.
+	// About half of them will be close enough to need a full outline check.
+	Random::Seed(0);
+	int count = MASK_BATCH * MASK_BATCHES;
+	vector<Point> sA(masks.size() * count);
+	vector<Point> vA(sA.size());
+	vector<Angle> facing(masks.size() * MASK_BATCHES);
+	for(unsigned m = 0; m < masks.size(); ++m)
+	{
+		double radius = masks[m]->Radius();
+		for(int i = 0; i < count; ++i)
+		{
+			unsigned index = m * count + i;
+			sA[index] = Point(Random::Real() - .5, Random::Real() - .5) * (4. * radius);
+			vA[index] = Angle::Random().Unit() * (3. * radius * Random::Real());
+		}
+		for(int i = 0; i < MASK_BATCHES; ++i)
+			facing[m * MASK_BATCHES + i] = Angle::Random();
+	}
+	
+	// First, check that every result is exactly what it used to be.
+	vector<double> batch(count);
+	int mismatches = 0;
+	for(unsigned m = 0; m < masks.size(); ++m)
+	{
+		const Mask &mask = *masks[m];
+		for(int b = 0; b < MASK_BATCHES; ++b)
+		{
+			unsigned first = m * count + b * MASK_BATCH;
+			Angle angle = facing[m * MASK_BATCHES + b];
+			mask.Collide(&sA[first], &vA[first], MASK_BATCH, angle, &batch[b * MASK_BATCH]);
+			for(int i = 0; i < MASK_BATCH; ++i)
+			{
+				double expected = ReferenceCollide(mask, sA[first + i], vA[first + i], angle);
+				mismatches += (mask.Collide(sA[first + i], vA[first + i], angle) != expected);
+				mismatches += (batch[b * MASK_BATCH + i] != expected);
+				mismatches += (mask.Range(sA[first + i], angle) != ReferenceRange(mask, sA[first + i], angle));
+				mismatches += (mask.Contains(sA[first + i], angle) != ReferenceContains(mask, sA[first + i], angle));
+			}
+		}
+	}
+	
+	// Then, time each version of each test. Sum up the results so that the
+	// compiler cannot skip any of them.
+	const char *NAMES[] = {"collide (reference)", "collide", "collide (batch)",
+		"range (reference)", "range", "contains (reference)", "contains"};
+	const int TESTS = sizeof(NAMES) / sizeof(NAMES[0]);
+	double times[TESTS] = {};
+	double sum = 0.;
+	for(int r = 0; r < repeats; ++r)
+		for(int test = 0; test < TESTS; ++test)
+		{
+			FrameTimer timer;
+			for(unsigned m = 0; m < masks.size(); ++m)
+			{
+				const Mask &mask = *masks[m];
+				for(int b = 0; b < MASK_BATCHES; ++b)
+				{
+					unsigned first = m * count + b * MASK_BATCH;
+					Angle angle = facing[m * MASK_BATCHES + b];
+					if(test == 2)
+					{
+						mask.Collide(&sA[first], &vA[first], MASK_BATCH, angle, batch.data());
+						for(int i = 0; i < MASK_BATCH; ++i)
+							sum += batch[i];
+						continue;
+					}
+					for(unsigned i = first; i < first + MASK_BATCH; ++i)
+					{
+						if(test == 0)
+							sum += ReferenceCollide(mask, sA[i], vA[i], angle);
+						else if(test == 1)
+							sum += mask.Collide(sA[i], vA[i], angle);
+						else if(test == 3)
+							sum += ReferenceRange(mask, sA[i], angle);
+						else if(test == 4)
+							sum += mask.Range(sA[i], angle);
+						else if(test == 5)
+							sum += ReferenceContains(mask, sA[i], angle);
+						else
+							sum += mask.Contains(sA[i], angle);
+					}
+				}
+			}
+			times[test] += timer.Time();
+		}
+	
+	cout << "Mask benchmark: " << masks.size() << " ship outlines (" << vertices
+		<< " vertices), " << sA.size() << " segments, " << repeats << " repeats." << endl;
+	cout << endl;
+	cout << setw(22) << left << "test" << right << setw(12) << "ns / test" << setw(10) << "speedup" << endl;
+	cout << fixed << setprecision(1);
+	for(int test = 0; test < TESTS; ++test)
+	{
+		double reference = times[test < 3 ? 0 : test < 5 ? 3 : 5];
+		cout << setw(22) << left << NAMES[test] << right
+			<< setw(12) << 1e9 * times[test] / (repeats * sA.size())
+			<< setw(9) << reference / times[test] << "x" << endl;
+	}
+	cout << endl;
+	cout << "Mismatched results: " << mismatches << " (checksum " << sum << ")" << endl;
+	
+	return mismatches ? 1 : 0;
+}
+
+
+
+// Time reading and decoding every image in the images folder:
+// --benchmark-images
+int Benchmark::RunImages(const char * const *argv)
+{
+	Files::Init(argv);
+	
+	// Load every image, including the @2x and landscape ones that the game
+	// skips when running without graphics. Each is given the same sprite name
+	// that the game would give it, so the frames and @2x versions of a sprite
+	// all belong to one sprite and ship and asteroid sprites also get masks.
+	SpriteQueue queue;
+	queue.SkipTextures();
+	const string &directory = Files::Images();
+	for(const string &path : Files::RecursiveList(directory))
+	{
+		size_t length = path.length();
+		if(length < 4 || (path.compare(length - 4, 4, ".png") && path.compare(length - 4, 4, ".jpg")))
+			continue;
+		queue.Add(GameData::Name(path.substr(directory.length())), path);
+	}
+	queue.Finish();
+	
+	cout << queue.Throughput() << endl;
+	return 0;
+}
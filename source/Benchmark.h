@@ -0,0 +1,45 @@
+/* Benchmark.h
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+
+
+// Class for running the game engine without any graphics, as fast as it can
+// go, to measure how long each part of a step takes. The scenario is always
+// the same: the player's ship (a shuttle) takes off from the first planet in
+// the chosen system, with two copies of every fleet that the system can have
+// already in action around it. Given the same random seed, two runs will have
+// exactly the same outcome, so the "checksum" that is printed at the end can
+// be used to check that an optimization did not change the game's behavior.
+// There are also "micro-benchmarks" that time one piece of the engine on its
+// own, comparing it to a simple reference version of the same code.
+class Benchmark {
+public:
+	// Run the benchmark described by the given command line arguments:
+	// --benchmark <system> [<steps> [<seed>]]
+	// The return value is the exit code for the program.
+	static int Run(const char * const *argv);
+	
+	// Time the collision mask tests on the outlines of every ship sprite:
+	// --benchmark-masks [<repeats>]
+	static int RunMasks(const char * const *argv);
+	
+	// Time reading and decoding every image in the images folder:
+	// --benchmark-images
+	static int RunImages(const char * const *argv);
+};
+
+
+
+#endif
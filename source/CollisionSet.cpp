@@ -0,0 +1,181 @@
+/* CollisionSet.cpp
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "CollisionSet.h"
+
+#include "Point.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+	// Find the cell coordinate that the given position falls in. Positions are
+	// clamped so that the conversion to an integer is always well defined.
+	int Cell(double position, int shift)
+	{
+		static const double LIMIT = 1e9;
+		return static_cast<int>(floor(max(-LIMIT, min(LIMIT, position)))) >> shift;
+	}
+}
+
+
+
+// The cell size and the number of cells along each axis are rounded down
+// to a power of two.
+CollisionSet::CollisionSet(unsigned cellSize, unsigned cellCount)
+{
+	SHIFT = 0;
+	while((2u << SHIFT) <= cellSize)
+		++SHIFT;
+	int bits = 0;
+	while((2u << bits) <= cellCount)
+		++bits;
+	MASK = (1 << bits) - 1;
+	CELLS = 1u << (2 * bits);
+	
+	counts.resize(CELLS + 1, 0);
+}
+
+
+
+// Remove all the objects from the set.
+void CollisionSet::Clear()
+{
+	all.clear();
+	added.clear();
+	sorted.clear();
+}
+
+
+
+// Add a ship, covering all the cells within the given radius of its center.
+void CollisionSet::Add(Ship &ship, const Point &center, double radius)
+{
+	unsigned index = all.size();
+	all.push_back(&ship);
+	
+	int minX = Cell(center.X() - radius, SHIFT);
+	int minY = Cell(center.Y() - radius, SHIFT);
+	int maxX = Cell(center.X() + radius, SHIFT);
+	int maxY = Cell(center.Y() + radius, SHIFT);
+	// If an object covers more cells than the grid has, each cell only needs
+	// to record it once.
+	maxX = min(maxX, minX + MASK);
+	maxY = min(maxY, minY + MASK);
+	for(int y = minY; y <= maxY; ++y)
+		for(int x = minX; x <= maxX; ++x)
+			added.emplace_back(index, x, y);
+}
+
+
+
+// Once all objects have been added, sort them into the grid cells.
+void CollisionSet::Finish()
+{
+	// Do a counting sort of the entries by the (wrapped) cell they are in.
+	fill(counts.begin(), counts.end(), 0);
+	for(const Entry &entry : added)
+		++counts[(entry.y & MASK) * (MASK + 1) + (entry.x & MASK) + 1];
+	for(unsigned i = 1; i <= CELLS; ++i)
+		counts[i] += counts[i - 1];
+	
+	// Use a copy of the starting indices as the insertion points.
+	sorted.resize(added.size());
+	vector<unsigned> next(counts.begin(), counts.end() - 1);
+	for(const Entry &entry : added)
+		sorted[next[(entry.y & MASK) * (MASK + 1) + (entry.x & MASK)]++] = entry;
+	
+	stamps.assign(all.size(), stamp);
+}
+
+
+
+// Get all the ships that may intersect the line segment from the given
+// point to that point plus the given vector, padded by the given radius.
+const vector<Ship *> &CollisionSet::Line(const Point &from, const Point &vector, double radius) const
+{
+	Point to = from + vector;
+	return Box(
+		min(from.X(), to.X()) - radius,
+		min(from.Y(), to.Y()) - radius,
+		max(from.X(), to.X()) + radius,
+		max(from.Y(), to.Y()) + radius);
+}
+
+
+
+// Get all the ships that may be within the given circle.
+const vector<Ship *> &CollisionSet::Circle(const Point &center, double radius) const
+{
+	return Box(center.X() - radius, center.Y() - radius, center.X() + radius, center.Y() + radius);
+}
+
+
+
+// Get all the ships in this set.
+const vector<Ship *> &CollisionSet::All() const
+{
+	return all;
+}
+
+
+
+// Get all the ships in any of the cells overlapping the given box.
+const vector<Ship *> &CollisionSet::Box(double left, double top, double right, double bottom) const
+{
+	result.clear();
+	
+	int minX = Cell(left, SHIFT);
+	int minY = Cell(top, SHIFT);
+	int maxX = Cell(right, SHIFT);
+	int maxY = Cell(bottom, SHIFT);
+	// If the box covers the whole grid, every object is a candidate.
+	if(maxX - minX >= MASK || maxY - minY >= MASK)
+	{
+		result = all;
+		return result;
+	}
+	
+	// Each query gets a new stamp. If the counter ever wraps around, reset all
+	// the stamps so that no object is mistakenly marked as already found.
+	if(!++stamp)
+	{
+		stamp = 1;
+		fill(stamps.begin(), stamps.end(), 0);
+	}
+	
+	indices.clear();
+	for(int y = minY; y <= maxY; ++y)
+		for(int x = minX; x <= maxX; ++x)
+		{
+			unsigned cell = (y & MASK) * (MASK + 1) + (x & MASK);
+			for(unsigned i = counts[cell]; i < counts[cell + 1]; ++i)
+			{
+				const Entry &entry = sorted[i];
+				if(entry.x == x && entry.y == y && stamps[entry.index] != stamp)
+				{
+					stamps[entry.index] = stamp;
+					indices.push_back(entry.index);
+				}
+			}
+		}
+	
+	// Return the objects in the order they were added, so that the results of
+	// collision detection do not depend on how the grid is laid out.
+	sort(indices.begin(), indices.end());
+	for(unsigned index : indices)
+		result.push_back(all[index]);
+	
+	return result;
+}
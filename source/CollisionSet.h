@@ -0,0 +1,94 @@
+/* CollisionSet.h
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef COLLISION_SET_H_
+#define COLLISION_SET_H_
+
+#include <vector>
+
+class Point;
+class Ship;
+
+
+
+// A CollisionSet is a uniform grid "broad phase" for collision detection. All
+// the ships in the current system are added to it once per step, each one
+// covering every grid cell its bounding circle touches. Then, instead of
+// checking every projectile against every ship, the engine asks for the ships
+// whose cells overlap a given line segment or circle, and only runs the exact
+// (mask-based) collision tests on those. The grid wraps around, so a small
+// number of cells can cover a system of any size; an object's cell coordinates
+// are stored along with it to weed out false matches from the wrapping. Query
+// results are always returned in the order that the ships were added.
+class CollisionSet {
+public:
+	// The cell size and the number of cells along each axis are rounded down
+	// to a power of two.
+	CollisionSet(unsigned cellSize, unsigned cellCount);
+	
+	// Remove all the objects from the set.
+	void Clear();
+	// Add a ship, covering all the cells within the given radius of its center.
+	void Add(Ship &ship, const Point &center, double radius);
+	// Once all objects have been added, sort them into the grid cells.
+	void Finish();
+	
+	// Get all the ships that may intersect the line segment from the given
+	// point to that point plus the given vector, padded by the given radius.
+	const std::vector<Ship *> &Line(const Point &from, const Point &vector, double radius = 0.) const;
+	// Get all the ships that may be within the given circle.
+	const std::vector<Ship *> &Circle(const Point &center, double radius) const;
+	// Get all the ships in this set.
+	const std::vector<Ship *> &All() const;
+	
+	
+private:
+	// Get all the ships in any of the cells overlapping the given box.
+	const std::vector<Ship *> &Box(double left, double top, double right, double bottom) const;
+	
+	
+private:
+	class Entry {
+	public:
+		Entry() = default;
+		Entry(unsigned index, int x, int y) : index(index), x(x), y(y) {}
+		
+		unsigned index;
+		int x;
+		int y;
+	};
+	
+	
+private:
+	// The cell size is 1 << SHIFT, and there are (MASK + 1) cells in each axis.
+	int SHIFT;
+	int MASK;
+	unsigned CELLS;
+	
+	std::vector<Ship *> all;
+	std::vector<Entry> added;
+	std::vector<Entry> sorted;
+	// The start of each cell's entries in the sorted list. This has one extra
+	// element at the end so that cell i runs from counts[i] to counts[i + 1].
+	std::vector<unsigned> counts;
+	
+	// Scratch space for returning query results. Each ship's "stamp" records
+	// the last query that found it, so it is not returned twice.
+	mutable std::vector<Ship *> result;
+	mutable std::vector<unsigned> indices;
+	mutable std::vector<unsigned> stamps;
+	mutable unsigned stamp = 0;
+};
+
+
+
+#endif
@@ -12,33 +12,60 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "ConditionSet.h"
 
+#include "ConditionStore.h"
 #include "DataNode.h"
 #include "DataWriter.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace std;
 
 namespace {
-	typedef int (*BinFun)(int, int);
-	BinFun Op(const string &op)
+	// All the operators that a condition can use. The comparisons are listed
+	// first, followed by the operators that assign a value.
+	enum {EQ, NE, LT, GT, LE, GE, SET, ADD, SUB, MIN, MAX};
+	const char *OPERATORS[] = {"==", "!=", "<", ">", "<=", ">=", "=", "+=", "-=", "<?=", ">?="};
+	const int OPERATOR_COUNT = sizeof(OPERATORS) / sizeof(OPERATORS[0]);
+	
+	// Get the index of the given operator, or -1 if it is not recognized.
+	int Op(const string &op)
+	{
+		for(int i = 0; i < OPERATOR_COUNT; ++i)
+			if(op == OPERATORS[i])
+				return i;
+		return -1;
+	}
+	
+	int Evaluate(int op, int a, int b)
 	{
-		static const map<string, BinFun> opMap = {
-			{"==", [](int a, int b) -> int { return a == b; }},
-			{"!=", [](int a, int b) -> int { return a != b; }},
-			{"<", [](int a, int b) -> int { return a < b; }},
-			{">", [](int a, int b) -> int { return a > b; }},
-			{"<=", [](int a, int b) -> int { return a <= b; }},
-			{">=", [](int a, int b) -> int { return a >= b; }},
-			{"=", [](int a, int b) { return b; }},
-			{"+=", [](int a, int b) { return a + b; }},
-			{"-=", [](int a, int b) { return a - b; }},
-			{"<?=", [](int a, int b) { return min(a, b); }},
-			{">?=", [](int a, int b) { return max(a, b); }}
-		};
-		
-		auto it = opMap.find(op);
-		return (it != opMap.end() ? it->second : nullptr);
+		switch(op)
+		{
+			case EQ:
+				return a == b;
+			case NE:
+				return a != b;
+			case LT:
+				return a < b;
+			case GT:
+				return a > b;
+			case LE:
+				return a <= b;
+			case GE:
+				return a >= b;
+			case SET:
+				return b;
+			case ADD:
+				return a + b;
+			case SUB:
+				return a - b;
+			case MIN:
+				return min(a, b);
+			case MAX:
+				return max(a, b);
+			default:
+				return 0;
+		}
 	}
 }
 
@@ -57,7 +84,7 @@ void ConditionSet::Load(const DataNode &node)
 void ConditionSet::Save(DataWriter &out) const
 {
 	for(const Entry &entry : entries)
-		out.Write(entry.name, entry.op, entry.value);
+		out.Write(ConditionStore::Name(entry.index), OPERATORS[entry.op], entry.value);
 	for(const ConditionSet &child : children)
 	{
 		out.Write(child.isOr ? "or" : "and");
@@ -91,7 +118,7 @@ void ConditionSet::Add(const DataNode &node)
 			node.PrintTrace("Unrecognized condition expression:");
 	}
 	else if(node.Size() == 1 && node.Token(0) == "never")
-		entries.emplace_back("", "!=", 0);
+		entries.emplace_back("", NE, 0);
 	else if(node.Size() == 1 && (node.Token(0) == "and" || node.Token(0) == "or"))
 	{
 		children.emplace_back();
@@ -106,17 +133,17 @@ void ConditionSet::Add(const DataNode &node)
 bool ConditionSet::Add(const string &firstToken, const string &secondToken)
 {
 	if(firstToken == "not")
-		entries.emplace_back(secondToken, "==", 0);
+		entries.emplace_back(secondToken, EQ, 0);
 	else if(firstToken == "has")
-		entries.emplace_back(secondToken, "!=", 0);
+		entries.emplace_back(secondToken, NE, 0);
 	else if(firstToken == "set")
-		entries.emplace_back(secondToken, "=", 1);
+		entries.emplace_back(secondToken, SET, 1);
 	else if(firstToken == "clear")
-		entries.emplace_back(secondToken, "=", 0);
+		entries.emplace_back(secondToken, SET, 0);
 	else if(secondToken == "++")
-		entries.emplace_back(firstToken, "+=", 1);
+		entries.emplace_back(firstToken, ADD, 1);
 	else if(secondToken == "--")
-		entries.emplace_back(firstToken, "-=", 1);
+		entries.emplace_back(firstToken, SUB, 1);
 	else
 		return false;
 	
@@ -127,22 +154,21 @@ bool ConditionSet::Add(const string &firstToken, const string &secondToken)
 
 bool ConditionSet::Add(const string &name, const string &op, int value)
 {
-	BinFun fun = Op(op);
-	if(!fun || isnan(value))
+	int index = Op(op);
+	if(index < 0 || isnan(value))
 		return false;
 	
-	entries.emplace_back(name, op, value);
+	entries.emplace_back(name, index, value);
 	return true;
 }
 
 
 
-bool ConditionSet::Test(const map<string, int> &conditions) const
+bool ConditionSet::Test(const ConditionStore &conditions) const
 {
 	for(const Entry &entry : entries)
 	{
-		auto it = conditions.find(entry.name);
-		bool result = entry.fun(it != conditions.end() ? it->second : 0, entry.value);
+		bool result = Evaluate(entry.op, conditions.Get(entry.index), entry.value);
 		// If this is a set of "and" conditions, bail out as soon as one of them
 		// returns false. If it is an "or", bail out if anything returns true.
 		if(result == isOr)
@@ -162,12 +188,12 @@ bool ConditionSet::Test(const map<string, int> &conditions) const
 
 
 
-void ConditionSet::Apply(map<string, int> &conditions) const
+void ConditionSet::Apply(ConditionStore &conditions) const
 {
 	for(const Entry &entry : entries)
 	{
-		int &c = conditions[entry.name];
-		c = entry.fun(c, entry.value);
+		int &c = conditions[entry.index];
+		c = Evaluate(entry.op, c, entry.value);
 	}
 	for(const ConditionSet &child : children)
 		child.Apply(conditions);
@@ -175,7 +201,7 @@ void ConditionSet::Apply(map<string, int> &conditions) const
 
 
 
-ConditionSet::Entry::Entry(const string &name, const string &op, int value)
-	: name(name), op(op), fun(Op(op)), value(value)
+ConditionSet::Entry::Entry(const string &name, int op, int value)
+	: index(ConditionStore::Index(name)), op(op), value(value)
 {
 }
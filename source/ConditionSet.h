@@ -13,10 +13,10 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef CONDITION_SET_H_
 #define CONDITION_SET_H_
 
-#include <map>
 #include <string>
 #include <vector>
 
+class ConditionStore;
 class DataNode;
 class DataWriter;
 
@@ -25,7 +25,8 @@ class DataWriter;
 // A condition set is a collection of operations on the player's set of named
 // "conditions". This includes "test" operations that just check the values of
 // those conditions, and other operations that can be "applied" to change the
-// values.
+// values. Each condition name is converted to its ConditionStore index when the
+// set is loaded, so applying or testing the set does not look up any names.
 class ConditionSet {
 public:
 	// Load a set of conditions from the children of this node.
@@ -41,20 +42,20 @@ public:
 	bool Add(const std::string &firstToken, const std::string &secondToken);
 	bool Add(const std::string &name, const std::string &op, int value);
 	
-	bool Test(const std::map<std::string, int> &conditions) const;
-	void Apply(std::map<std::string, int> &conditions) const;
+	bool Test(const ConditionStore &conditions) const;
+	void Apply(ConditionStore &conditions) const;
 	
 	
 private:
 	class Entry {
 	public:
-		Entry(const std::string &name, const std::string &op, int value);
+		Entry(const std::string &name, int op, int value);
 		
-		std::string name;
-		// This needs to be saved for saving conditions.
-		std::string op;
-		int (*fun)(int, int);
-		double value;
+		// The condition's index in the ConditionStore.
+		unsigned index;
+		// The operator's index in the table of operators.
+		int op;
+		int value;
 	};
 	
 	
@@ -0,0 +1,177 @@
+/* ConditionStore.cpp
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "ConditionStore.h"
+
+using namespace std;
+
+namespace {
+	// Every condition name that has been given an index. The names are never
+	// removed, so pointers to them stay valid.
+	map<string, unsigned> &Indices()
+	{
+		static map<string, unsigned> indices;
+		return indices;
+	}
+	
+	vector<const string *> &Names()
+	{
+		static vector<const string *> names;
+		return names;
+	}
+}
+
+
+
+// Get the index of the condition with the given name, or the name of the
+// condition with the given index.
+unsigned ConditionStore::Index(const string &name)
+{
+	auto it = Indices().emplace(name, Names().size());
+	if(it.second)
+		Names().push_back(&it.first->first);
+	return it.first->second;
+}
+
+
+
+const string &ConditionStore::Name(unsigned index)
+{
+	static const string EMPTY;
+	return (index < Names().size() ? *Names()[index] : EMPTY);
+}
+
+
+
+ConditionStore::ConditionStore(const ConditionStore &other)
+	: values(other.values)
+{
+	Reindex();
+}
+
+
+
+ConditionStore &ConditionStore::operator=(const ConditionStore &other)
+{
+	values = other.values;
+	Reindex();
+	return *this;
+}
+
+
+
+// Get the value of the given condition. If it is not set, it is zero.
+int ConditionStore::Get(unsigned index) const
+{
+	return (index < slots.size() && slots[index]) ? *slots[index] : 0;
+}
+
+
+
+int ConditionStore::Get(const string &name) const
+{
+	auto it = values.find(name);
+	return (it == values.end()) ? 0 : it->second;
+}
+
+
+
+// Get a reference to the given condition's value, setting it to zero if
+// it is not set yet.
+int &ConditionStore::operator[](unsigned index)
+{
+	if(index < slots.size() && slots[index])
+		return *slots[index];
+	
+	return (*this)[Name(index)];
+}
+
+
+
+int &ConditionStore::operator[](const string &name)
+{
+	auto it = values.lower_bound(name);
+	if(it != values.end() && it->first == name)
+		return it->second;
+	
+	it = values.emplace_hint(it, name, 0);
+	unsigned index = Index(name);
+	if(slots.size() <= index)
+		slots.resize(index + 1, nullptr);
+	slots[index] = &it->second;
+	return it->second;
+}
+
+
+
+// Access the conditions that are set, in order of their names.
+bool ConditionStore::empty() const
+{
+	return values.empty();
+}
+
+
+
+ConditionStore::const_iterator ConditionStore::begin() const
+{
+	return values.begin();
+}
+
+
+
+ConditionStore::const_iterator ConditionStore::end() const
+{
+	return values.end();
+}
+
+
+
+ConditionStore::const_iterator ConditionStore::find(const string &name) const
+{
+	return values.find(name);
+}
+
+
+
+ConditionStore::const_iterator ConditionStore::lower_bound(const string &name) const
+{
+	return values.lower_bound(name);
+}
+
+
+
+// Remove a range of conditions.
+void ConditionStore::erase(const_iterator first, const_iterator last)
+{
+	for(auto it = first; it != last; ++it)
+	{
+		unsigned index = Index(it->first);
+		if(index < slots.size())
+			slots[index] = nullptr;
+	}
+	values.erase(first, last);
+}
+
+
+
+// Point the index of each condition in the map to its value.
+void ConditionStore::Reindex()
+{
+	slots.clear();
+	for(auto &it : values)
+	{
+		unsigned index = Index(it.first);
+		if(slots.size() <= index)
+			slots.resize(index + 1, nullptr);
+		slots[index] = &it.second;
+	}
+}
@@ -0,0 +1,77 @@
+/* ConditionStore.h
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef CONDITION_STORE_H_
+#define CONDITION_STORE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+
+// Class storing the values of the player's named "conditions". Every condition
+// name that the game data or the player refers to is given a permanent index,
+// so a ConditionSet can be compiled when it is loaded to refer to conditions
+// by index, and testing it does not involve looking up any names. The store
+// still acts like a map from names to values, in order of the names, so the
+// conditions can be saved and loaded by name and searched for by prefix.
+class ConditionStore {
+public:
+	typedef std::map<std::string, int>::const_iterator const_iterator;
+	
+	
+public:
+	// Get the index of the condition with the given name, or the name of the
+	// condition with the given index.
+	static unsigned Index(const std::string &name);
+	static const std::string &Name(unsigned index);
+	
+	ConditionStore() = default;
+	ConditionStore(const ConditionStore &other);
+	ConditionStore(ConditionStore &&other) = default;
+	ConditionStore &operator=(const ConditionStore &other);
+	ConditionStore &operator=(ConditionStore &&other) = default;
+	
+	// Get the value of the given condition. If it is not set, it is zero.
+	int Get(unsigned index) const;
+	int Get(const std::string &name) const;
+	// Get a reference to the given condition's value, setting it to zero if
+	// it is not set yet.
+	int &operator[](unsigned index);
+	int &operator[](const std::string &name);
+	
+	// Access the conditions that are set, in order of their names.
+	bool empty() const;
+	const_iterator begin() const;
+	const_iterator end() const;
+	const_iterator find(const std::string &name) const;
+	const_iterator lower_bound(const std::string &name) const;
+	// Remove a range of conditions.
+	void erase(const_iterator first, const_iterator last);
+	
+	
+private:
+	// Point the index of each condition in the map to its value.
+	void Reindex();
+	
+	
+private:
+	std::map<std::string, int> values;
+	// A pointer to each condition's value, by index, or null if it is not set.
+	// Pointers to the elements of a map stay valid until they are erased.
+	std::vector<int *> slots;
+};
+
+
+
+#endif
@@ -14,11 +14,63 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Files.h"
 
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+
 using namespace std;
 
+namespace {
+	// Keywords up to this length fit in a std::string without allocating any
+	// memory, so looking them up in the table of interned strings is cheap.
+	const ptrdiff_t MAX_INTERNED = 15;
+	
+	// Get the one shared copy of the given keyword. The strings in the table
+	// are never removed, and unordered_set never moves its elements, so the
+	// returned pointer stays valid for the rest of the program.
+	const string *Intern(const char *start, const char *end)
+	{
+		static mutex internMutex;
+		static unordered_set<string> interned;
+		
+		string key = (start == end) ? string() : string(start, end);
+		lock_guard<mutex> lock(internMutex);
+		return &*interned.insert(move(key)).first;
+	}
+	
+	// Append the raw bytes of the given value to a binary buffer.
+	template <class Type>
+	void Append(string &out, const Type &value)
+	{
+		out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+	
+	// Read a value from a binary buffer, if there is enough data left in it.
+	template <class Type>
+	bool Extract(const char *&it, const char *end, Type &value)
+	{
+		if(static_cast<size_t>(end - it) < sizeof(value))
+			return false;
+		memcpy(&value, it, sizeof(value));
+		it += sizeof(value);
+		return true;
+	}
+}
+
+
+
+DataFile::DataFile()
+	: arena(make_shared<DataNode::Arena>()), root(arena.get(), 0)
+{
+	// Node 0 is the root, which is the parent of all the top-level nodes.
+	arena->nodes.emplace_back();
+}
+
 
 
 DataFile::DataFile(const string &path)
+	: DataFile()
 {
 	Load(path);
 }
@@ -26,6 +78,7 @@ DataFile::DataFile(const string &path)
 
 
 DataFile::DataFile(istream &in)
+	: DataFile()
 {
 	Load(in);
 }
@@ -68,23 +121,145 @@ void DataFile::Load(istream &in)
 
 
 
-list<DataNode>::const_iterator DataFile::begin() const
+DataNode::const_iterator DataFile::begin() const
 {
 	return root.begin();
 }
 
 
 
-list<DataNode>::const_iterator DataFile::end() const
+DataNode::const_iterator DataFile::end() const
 {
 	return root.end();
 }
 
 
 
+// Append this file's nodes to the given string in a compact binary form, or
+// replace them with nodes read back from that form. The format depends on
+// this computer's byte order, so it is only good for caching the data.
+void DataFile::WriteBinary(string &out) const
+{
+	const vector<DataNode::Arena::Node> &nodes = arena->nodes;
+	Append(out, static_cast<uint32_t>(nodes.size()));
+	for(const DataNode::Arena::Node &node : nodes)
+		Append(out, node);
+	for(const string *token : arena->tokens)
+	{
+		Append(out, static_cast<uint32_t>(token->length()));
+		out += *token;
+	}
+	Append(out, static_cast<uint32_t>(warnings.size()));
+	for(const pair<uint32_t, string> &warning : warnings)
+	{
+		Append(out, warning.first);
+		Append(out, static_cast<uint32_t>(warning.second.length()));
+		out += warning.second;
+	}
+}
+
+
+
+bool DataFile::ReadBinary(const char *&it, const char *end)
+{
+	shared_ptr<DataNode::Arena> data = make_shared<DataNode::Arena>();
+	vector<DataNode::Arena::Node> &nodes = data->nodes;
+	vector<const string *> &tokens = data->tokens;
+	
+	uint32_t count = 0;
+	if(!Extract(it, end, count) || !count)
+		return false;
+	nodes.resize(count);
+	for(DataNode::Arena::Node &node : nodes)
+		if(!Extract(it, end, node))
+			return false;
+	
+	// The root has no parent or siblings.
+	if(nodes.front().parent || nodes.front().next)
+		return false;
+	
+	// The nodes are stored in the order they appeared in the file, so a parent
+	// always comes before its children and a node before its next sibling. Any
+	// link that points backward could make iterating over the nodes loop
+	// forever. Likewise, the tokens are stored in the same order as the nodes
+	// they belong to, so anything that does not match up means this data is corrupt.
+	for(uint32_t index = 0; index < count; ++index)
+	{
+		const DataNode::Arena::Node &node = nodes[index];
+		if((index && node.parent >= index) || node.firstToken != tokens.size())
+			return false;
+		if(node.next && (node.next <= index || node.next >= count))
+			return false;
+		if(node.firstChild && (node.firstChild <= index || node.lastChild < node.firstChild
+				|| node.lastChild >= count))
+			return false;
+		if(!node.firstChild && node.lastChild)
+			return false;
+		
+		for(uint32_t i = 0; i < node.tokenCount; ++i)
+		{
+			uint32_t length = 0;
+			if(!Extract(it, end, length) || static_cast<size_t>(end - it) < length)
+				return false;
+			
+			// Intern the same tokens that parsing the text would have.
+			if(!i && length <= MAX_INTERNED)
+				tokens.push_back(Intern(it, it + length));
+			else
+			{
+				data->strings.emplace_back(it, length);
+				tokens.push_back(&data->strings.back());
+			}
+			it += length;
+		}
+	}
+	
+	// Read the warnings that parsing the text produced, so that they can be
+	// printed again once all the cached files have been read successfully.
+	uint32_t warningCount = 0;
+	if(!Extract(it, end, warningCount))
+		return false;
+	vector<pair<uint32_t, string>> loadWarnings;
+	for(uint32_t i = 0; i < warningCount; ++i)
+	{
+		uint32_t index = 0;
+		uint32_t length = 0;
+		if(!Extract(it, end, index) || index >= count || !Extract(it, end, length)
+				|| static_cast<size_t>(end - it) < length)
+			return false;
+		loadWarnings.emplace_back(index, string(it, length));
+		it += length;
+	}
+	
+	arena = data;
+	root = DataNode(arena.get(), 0);
+	warnings.swap(loadWarnings);
+	return true;
+}
+
+
+
+// Print again any warnings that were produced when this file was parsed. This
+// is needed when the file is read back from its binary form instead.
+void DataFile::PrintWarnings() const
+{
+	for(const pair<uint32_t, string> &warning : warnings)
+		DataNode(arena.get(), warning.first).PrintTrace(warning.second);
+}
+
+
+
 void DataFile::Load(const char *it, const char *end)
 {
-	vector<DataNode *> stack(1, &root);
+	// There can be at most one node per line, so reserve enough space for that
+	// many nodes (and a few tokens each) to avoid reallocating as the arena grows.
+	vector<DataNode::Arena::Node> &nodes = arena->nodes;
+	vector<const string *> &tokens = arena->tokens;
+	size_t lines = count(it, end, '\n');
+	nodes.reserve(nodes.size() + lines);
+	tokens.reserve(tokens.size() + 3 * lines);
+	
+	vector<uint32_t> stack(1, 0);
 	vector<int> whiteStack(1, -1);
 	
 	for( ; it != end; ++it)
@@ -113,12 +288,20 @@ void DataFile::Load(const char *it, const char *end)
 		}
 		
 		// Add this node as a child of the proper node.
-		list<DataNode> &children = stack.back()->children;
-		children.emplace_back(stack.back());
-		DataNode &node = children.back();
+		uint32_t index = nodes.size();
+		uint32_t parent = stack.back();
+		nodes.emplace_back();
+		nodes.back().parent = parent;
+		nodes.back().firstToken = tokens.size();
+		if(nodes[parent].lastChild)
+			nodes[nodes[parent].lastChild].next = index;
+		else
+			nodes[parent].firstChild = index;
+		nodes[parent].lastChild = index;
+		DataNode::Arena::Node &node = nodes.back();
 		
 		// Remember where in the tree we are.
-		stack.push_back(&node);
+		stack.push_back(index);
 		whiteStack.push_back(white);
 		
 		// Tokenize the line. Skip comments and empty lines.
@@ -134,15 +317,23 @@ void DataFile::Load(const char *it, const char *end)
 			while(*it != '\n' && (isQuoted ? (*it != endQuote) : (*it > ' ')))
 				++it;
 			
-			// It ought to be legal to construct a string from an empty iterator
-			// range, but it appears that some libraries do not handle that case
-			// correctly. So:
-			if(start == it)
-				node.tokens.emplace_back();
+			// The first token of a line is usually a keyword, so it is interned.
+			// Any other token is stored in this file's arena. It ought to be
+			// legal to construct a string from an empty iterator range, but it
+			// appears that some libraries do not handle that case correctly. So:
+			if(!node.tokenCount && it - start <= MAX_INTERNED)
+				tokens.push_back(Intern(start, it));
 			else
-				node.tokens.emplace_back(start, it);
+			{
+				if(start == it)
+					arena->strings.emplace_back();
+				else
+					arena->strings.emplace_back(start, it);
+				tokens.push_back(&arena->strings.back());
+			}
+			++node.tokenCount;
 			if(isQuoted && *it == '\n')
-				node.PrintTrace("Closing quotation mark is missing:");
+				Warn(index, "Closing quotation mark is missing:");
 			
 			if(*it != '\n')
 			{
@@ -161,3 +352,13 @@ void DataFile::Load(const char *it, const char *end)
 		}
 	}
 }
+
+
+
+// Print a warning about the given node, and remember it so that it can be
+// printed again if this file is read back from its binary form.
+void DataFile::Warn(uint32_t index, const string &message)
+{
+	warnings.emplace_back(index, message);
+	DataNode(arena.get(), index).PrintTrace(message);
+}
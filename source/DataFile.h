@@ -15,8 +15,12 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "DataNode.h"
 
+#include <cstdint>
 #include <istream>
-#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 
 
@@ -26,25 +30,42 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 // it, it is a "child" of that node. Otherwise, it is a "sibling." Each node is
 // just a collection of one or more tokens that can be interpreted either as
 // strings or as floating point values; see DataNode for more information.
+// All the nodes of one DataFile are allocated from a single arena, and common
+// keywords are interned so that each copy of them does not need to be stored.
 class DataFile {
 public:
-	DataFile() = default;
+	DataFile();
 	DataFile(const std::string &path);
 	DataFile(std::istream &in);
 	
 	void Load(const std::string &path);
 	void Load(std::istream &in);
 	
-	std::list<DataNode>::const_iterator begin() const;
-	std::list<DataNode>::const_iterator end() const;
+	DataNode::const_iterator begin() const;
+	DataNode::const_iterator end() const;
+	
+	// Append this file's nodes to the given string in a compact binary form, or
+	// replace them with nodes read back from that form. The format depends on
+	// this computer's byte order, so it is only good for caching the data.
+	void WriteBinary(std::string &out) const;
+	bool ReadBinary(const char *&it, const char *end);
+	// Print again any warnings that were produced when this file was parsed. This
+	// is needed when the file is read back from its binary form instead.
+	void PrintWarnings() const;
 	
 	
 private:
 	void Load(const char *it, const char *end);
+	// Print a warning about the given node, and remember it so that it can be
+	// printed again if this file is read back from its binary form.
+	void Warn(uint32_t index, const std::string &message);
 	
 	
 private:
+	std::shared_ptr<DataNode::Arena> arena;
 	DataNode root;
+	// Warnings printed while parsing, with the index of the node each is about.
+	std::vector<std::pair<uint32_t, std::string>> warnings;
 };
 
 
@@ -22,25 +22,24 @@ using namespace std;
 
 
 
-DataNode::DataNode(const DataNode *parent)
-	: parent(parent)
-{
-	tokens.reserve(4);
-}
-
-
-
 DataNode::DataNode(const DataNode &other)
-	: children(other.children), tokens(other.tokens)
+	: arena(other.arena), owner(other.owner), index(other.index)
 {
+	// Nodes handed out by a DataFile do not own their arena, but any copy of
+	// them must keep it alive even if the DataFile is destroyed.
+	if(arena && !owner)
+		owner = arena->shared_from_this();
 }
 
 
 
 DataNode &DataNode::operator=(const DataNode &other)
 {
-	children = other.children;
-	tokens = other.tokens;
+	arena = other.arena;
+	owner = other.owner;
+	index = other.index;
+	if(arena && !owner)
+		owner = arena->shared_from_this();
 	return *this;
 }
 
@@ -48,14 +47,14 @@ DataNode &DataNode::operator=(const DataNode &other)
 
 int DataNode::Size() const
 {
-	return tokens.size();
+	return arena ? arena->nodes[index].tokenCount : 0;
 }
 
 
 
 const string &DataNode::Token(int index) const
 {
-	return tokens[index];
+	return *arena->tokens[arena->nodes[this->index].firstToken + index];
 }
 
 
@@ -63,17 +62,17 @@ const string &DataNode::Token(int index) const
 double DataNode::Value(int index) const
 {
 	// Check for empty strings and out-of-bounds indices.
-	if(static_cast<size_t>(index) >= tokens.size() || tokens[index].empty())
+	if(index < 0 || index >= Size() || Token(index).empty())
 	{
 		PrintTrace("Requested token index (" + to_string(index) + ") is out of bounds:");
 		return 0.;
 	}
 	
 	// Allowed format: "[+-]?[0-9]*[.]?[0-9]*([eE][+-]?[0-9]*)?".
-	const char *it = tokens[index].c_str();
+	const char *it = Token(index).c_str();
 	if(*it != '-' && *it != '.' && *it != '+' && !(*it >= '0' && *it <= '9'))
 	{
-		PrintTrace("Cannot convert value \"" + tokens[index] + "\" to a number:");
+		PrintTrace("Cannot convert value \"" + Token(index) + "\" to a number:");
 		return 0.;
 	}
 	
@@ -120,21 +119,21 @@ double DataNode::Value(int index) const
 
 bool DataNode::HasChildren() const
 {
-	return !children.empty();
+	return arena && arena->nodes[index].firstChild;
 }
 
 
 
-list<DataNode>::const_iterator DataNode::begin() const
+DataNode::const_iterator DataNode::begin() const
 {
-	return children.begin();
+	return const_iterator(arena, arena ? arena->nodes[index].firstChild : 0);
 }
 
 
 
-list<DataNode>::const_iterator DataNode::end() const
+DataNode::const_iterator DataNode::end() const
 {
-	return children.end();
+	return const_iterator(arena, 0);
 }
 
 
@@ -148,16 +147,19 @@ int DataNode::PrintTrace(const string &message) const
 		Files::LogError(message);
 	}
 	
-	int indent = 0;
-	if(parent)
-		indent = parent->PrintTrace() + 2;
-	if(tokens.empty())
+	// The root node of a file has no tokens and no parent.
+	if(!arena || !index)
+		return 0;
+	
+	int indent = DataNode(arena, arena->nodes[index].parent).PrintTrace() + 2;
+	if(!Size())
 		return indent;
 	
 	string line(indent, ' ');
-	for(const string &token : tokens)
+	for(int i = 0; i < Size(); ++i)
 	{
-		if(&token != &tokens.front())
+		const string &token = Token(i);
+		if(i)
 			line += ' ';
 		bool hasSpace = any_of(token.begin(), token.end(), [](char c) { return isspace(c); });
 		bool hasQuote = any_of(token.begin(), token.end(), [](char c) { return (c == '"'); });
@@ -171,3 +173,79 @@ int DataNode::PrintTrace(const string &message) const
 	
 	return indent;
 }
+
+
+
+DataNode::DataNode(const Arena *arena, uint32_t index)
+	: arena(arena), index(index)
+{
+}
+
+
+
+// Copying an iterator should not touch the arena's reference count.
+DataNode::const_iterator::const_iterator(const const_iterator &other)
+	: node(other.node.arena, other.node.index)
+{
+}
+
+
+
+DataNode::const_iterator &DataNode::const_iterator::operator=(const const_iterator &other)
+{
+	node.arena = other.node.arena;
+	node.index = other.node.index;
+	return *this;
+}
+
+
+
+const DataNode &DataNode::const_iterator::operator*() const
+{
+	return node;
+}
+
+
+
+const DataNode *DataNode::const_iterator::operator->() const
+{
+	return &node;
+}
+
+
+
+DataNode::const_iterator &DataNode::const_iterator::operator++()
+{
+	node.index = node.arena->nodes[node.index].next;
+	return *this;
+}
+
+
+
+DataNode::const_iterator DataNode::const_iterator::operator++(int)
+{
+	const_iterator result = *this;
+	++*this;
+	return result;
+}
+
+
+
+bool DataNode::const_iterator::operator==(const const_iterator &other) const
+{
+	return node.index == other.node.index;
+}
+
+
+
+bool DataNode::const_iterator::operator!=(const const_iterator &other) const
+{
+	return node.index != other.node.index;
+}
+
+
+
+DataNode::const_iterator::const_iterator(const Arena *arena, uint32_t index)
+	: node(arena, index)
+{
+}
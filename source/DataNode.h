@@ -13,7 +13,10 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef DATA_NODE_H_
 #define DATA_NODE_H_
 
-#include <list>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -25,9 +28,18 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 // The tokens of a node are separated by white space, with quotation marks being
 // used to group multiple words into a single token. If the token text contains
 // quotation marks, it should be enclosed in backticks instead.
+//
+// All the nodes and tokens of a file are stored in a single "arena" that is
+// shared by every DataNode that refers to it, so a DataNode is just a small
+// handle. Copying a node does not copy its children; instead, the copy keeps
+// the whole arena alive for as long as it exists.
 class DataNode {
 public:
-	DataNode(const DataNode *parent = nullptr);
+	class const_iterator;
+	
+	
+public:
+	DataNode() = default;
 	DataNode(const DataNode &other);
 	
 	DataNode &operator=(const DataNode &other);
@@ -37,21 +49,81 @@ public:
 	double Value(int index) const;
 	
 	bool HasChildren() const;
-	std::list<DataNode>::const_iterator begin() const;
-	std::list<DataNode>::const_iterator end() const;
+	const_iterator begin() const;
+	const_iterator end() const;
 	
 	// Print a message followed by a "trace" of this node and its parents.
 	int PrintTrace(const std::string &message = "") const;
 	
 	
 private:
-	std::list<DataNode> children;
-	std::vector<std::string> tokens;
-	const DataNode *parent = nullptr;
+	// The storage for all the nodes in one DataFile. Nodes refer to each other
+	// by their index in the "nodes" vector; index 0 is the file's root node,
+	// so it can also be used to mean "no node."
+	class Arena : public std::enable_shared_from_this<Arena> {
+	public:
+		class Node {
+		public:
+			uint32_t parent = 0;
+			uint32_t next = 0;
+			uint32_t firstChild = 0;
+			uint32_t lastChild = 0;
+			uint32_t firstToken = 0;
+			uint32_t tokenCount = 0;
+		};
+		
+	public:
+		std::vector<Node> nodes;
+		// Each token is either an interned keyword or one of the strings below.
+		std::vector<const std::string *> tokens;
+		std::deque<std::string> strings;
+	};
+	
+	
+private:
+	DataNode(const Arena *arena, uint32_t index);
+	
+	
+private:
+	const Arena *arena = nullptr;
+	// This is only set for nodes that were copied by the code using them, not
+	// for the nodes that the DataFile or an iterator hands out.
+	std::shared_ptr<const Arena> owner;
+	uint32_t index = 0;
 	
 	friend class DataFile;
 };
 
 
 
+// Iterator over the children of a DataNode. Each step just moves to the next
+// sibling in the arena, so iterating never allocates anything.
+class DataNode::const_iterator : public std::iterator<std::forward_iterator_tag, const DataNode> {
+public:
+	const_iterator() = default;
+	// Copying an iterator should not touch the arena's reference count.
+	const_iterator(const const_iterator &other);
+	const_iterator &operator=(const const_iterator &other);
+	
+	const DataNode &operator*() const;
+	const DataNode *operator->() const;
+	const_iterator &operator++();
+	const_iterator operator++(int);
+	
+	bool operator==(const const_iterator &other) const;
+	bool operator!=(const const_iterator &other) const;
+	
+	
+private:
+	const_iterator(const Arena *arena, uint32_t index);
+	
+	
+private:
+	DataNode node;
+	
+	friend class DataNode;
+};
+
+
+
 #endif
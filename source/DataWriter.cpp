@@ -23,17 +23,28 @@ const string DataWriter::space = " ";
 
 
 
-DataWriter::DataWriter(const string &path)
-	: path(path), before(&indent)
+// A writer with no path only stores what is written in memory, so that it
+// can be retrieved with GetString() and written to disk some other way.
+DataWriter::DataWriter()
+	: before(&indent)
 {
 	out.precision(8);
 }
 
 
 
+DataWriter::DataWriter(const string &path)
+	: DataWriter()
+{
+	this->path = path;
+}
+
+
+
 DataWriter::~DataWriter()
 {
-	Files::Write(path, out.str());
+	if(!path.empty())
+		Files::Write(path, out.str());
 }
 
 
@@ -112,3 +123,11 @@ void DataWriter::WriteToken(const string &a)
 {
 	WriteToken(a.c_str());
 }
+
+
+
+// Get everything that has been written so far.
+string DataWriter::GetString() const
+{
+	return out.str();
+}
@@ -27,6 +27,9 @@ class DataNode;
 // automatically adds quotation marks around strings if they contain whitespace.
 class DataWriter {
 public:
+	// A writer with no path only stores what is written in memory, so that it
+	// can be retrieved with GetString() and written to disk some other way.
+	DataWriter();
 	DataWriter(const std::string &path);
 	~DataWriter();
 	
@@ -46,6 +49,9 @@ public:
   template <class A>
 	void WriteToken(const A &a);
 	
+	// Get everything that has been written so far.
+	std::string GetString() const;
+	
 	
 private:
 	std::string path;
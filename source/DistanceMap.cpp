@@ -12,23 +12,77 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "DistanceMap.h"
 
+#include "GameData.h"
 #include "Outfit.h"
 #include "Planet.h"
 #include "PlayerInfo.h"
 #include "Ship.h"
 #include "System.h"
 
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 using namespace std;
 
 
 
+// A map stored in the cache. Each system is given an index, and the distance
+// to each system and the next system along its route are stored by index.
+class DistanceMap::Routes {
+public:
+	// All the systems that maps are cached for, and the index of each one.
+	class Systems {
+	public:
+		vector<const System *> list;
+		unordered_map<const System *, int> index;
+	};
+	
+	
+public:
+	// Get the index of the given system, or -1 if it is not in this map.
+	int Index(const System *system) const;
+	
+	
+public:
+	shared_ptr<const Systems> systems;
+	// The distance to each system, or -1 if it cannot be reached.
+	vector<int> distance;
+	// The index of the next system along the route, or -1 if there is none.
+	vector<int> next;
+	
+	// The cache is shared by all threads. Searches that are in progress when it
+	// is cleared hold on to their own copy of the maps they are using.
+	static mutex cacheMutex;
+	static shared_ptr<const Systems> allSystems;
+	static map<pair<const System *, int>, shared_ptr<const Routes>> cache;
+};
+
+mutex DistanceMap::Routes::cacheMutex;
+shared_ptr<const DistanceMap::Routes::Systems> DistanceMap::Routes::allSystems;
+map<pair<const System *, int>, shared_ptr<const DistanceMap::Routes>> DistanceMap::Routes::cache;
+
+
+
+// Get the index of the given system, or -1 if it is not in this map.
+int DistanceMap::Routes::Index(const System *system) const
+{
+	auto it = systems->index.find(system);
+	return (it == systems->index.end()) ? -1 : it->second;
+}
+
+
+
 // If a player is given, the map will only use hyperspace paths known to the
 // player; that is, one end of the path has been visited. Also, if the
 // player's flagship has a jump drive, the jumps will be make use of it.
 DistanceMap::DistanceMap(const System *center, int maxCount, int maxDistance)
 	: maxCount(maxCount), maxDistance(maxDistance), useWormholes(false)
 {
-	Init(center);
+	if(center && maxCount < 0 && maxDistance < 0)
+		routes = Cached(center, true, false, false);
+	else
+		Init(center, true, false);
 }
 
 
@@ -47,7 +101,10 @@ DistanceMap::DistanceMap(const PlayerInfo &player, const System *center)
 	if(!center)
 		return;
 	
-	Init(center, player.Flagship());
+	bool hasHyper;
+	bool hasJump;
+	Capabilities(player.Flagship(), hasHyper, hasJump);
+	Init(center, hasHyper, hasJump);
 }
 
 
@@ -61,7 +118,13 @@ DistanceMap::DistanceMap(const Ship &ship, const System *destination)
 	if(!source || !destination)
 		return;
 	
-	Init(destination, &ship);
+	// The search stops once a path from the source is found, and the paths
+	// to all the systems that have been visited by then are the same as they
+	// would be in a full search. So, the cached map can be used instead.
+	bool hasHyper;
+	bool hasJump;
+	Capabilities(&ship, hasHyper, hasJump);
+	routes = Cached(destination, hasHyper, hasJump, true);
 }
 
 
@@ -69,6 +132,9 @@ DistanceMap::DistanceMap(const Ship &ship, const System *destination)
 // Find out if the given system is reachable.
 bool DistanceMap::HasRoute(const System *system) const
 {
+	if(routes)
+		return (Distance(system) >= 0);
+	
 	auto it = distance.find(system);
 	return (it != distance.end());
 }
@@ -78,6 +144,12 @@ bool DistanceMap::HasRoute(const System *system) const
 // Find out how many jumps away the given system is.
 int DistanceMap::Distance(const System *system) const
 {
+	if(routes)
+	{
+		int index = routes->Index(system);
+		return (index < 0) ? -1 : routes->distance[index];
+	}
+	
 	auto it = distance.find(system);
 	if(it == distance.end())
 		return -1;
@@ -106,6 +178,14 @@ int DistanceMap::Cost(const System *system) const
 // should I jump to next?
 const System *DistanceMap::Route(const System *system) const
 {
+	if(routes)
+	{
+		int index = routes->Index(system);
+		if(index < 0 || routes->next[index] < 0)
+			return nullptr;
+		return routes->systems->list[routes->next[index]];
+	}
+	
 	auto it = route.find(system);
 	if(it == route.end())
 		return nullptr;
@@ -118,15 +198,95 @@ const System *DistanceMap::Route(const System *system) const
 // Access the distance map directly.
 const map<const System *, int> DistanceMap::Distances() const
 {
-	return distance;
+	if(!routes)
+		return distance;
+	
+	map<const System *, int> result;
+	for(unsigned i = 0; i < routes->distance.size(); ++i)
+		if(routes->distance[i] >= 0)
+			result[routes->systems->list[i]] = routes->distance[i];
+	return result;
+}
+
+
+
+// Discard all the cached maps. This must be done whenever a hyperspace
+// link, a wormhole, or the list of systems changes.
+void DistanceMap::ClearCache()
+{
+	lock_guard<mutex> lock(Routes::cacheMutex);
+	Routes::allSystems.reset();
+	Routes::cache.clear();
 }
 
 
 
-// Depending on the capabilities of the given ship, use hyperspace paths,
-// jump drive paths, or both to find the shortest route. Bail out if the
-// source system or the maximum count is reached.
-void DistanceMap::Init(const System *center, const Ship *ship)
+// Get the cached map from the given center, searching from it if it is
+// not in the cache yet. If "toCenter" is set, the routes lead toward the
+// center instead of away from it, and may travel through wormholes.
+shared_ptr<const DistanceMap::Routes> DistanceMap::Cached(const System *center, bool hasHyper, bool hasJump, bool toCenter)
+{
+	lock_guard<mutex> lock(Routes::cacheMutex);
+	if(!Routes::allSystems)
+	{
+		shared_ptr<Routes::Systems> systems = make_shared<Routes::Systems>();
+		for(const auto &it : GameData::Systems())
+		{
+			systems->index[&it.second] = systems->list.size();
+			systems->list.push_back(&it.second);
+		}
+		Routes::allSystems = systems;
+	}
+	
+	shared_ptr<const Routes> &cached = Routes::cache[make_pair(center, hasHyper + 2 * hasJump + 4 * toCenter)];
+	if(cached)
+		return cached;
+	
+	// Do a full search, then convert the result into a list of distances and
+	// routes by system index.
+	DistanceMap search;
+	search.useWormholes = toCenter;
+	search.reverseWormholes = toCenter;
+	search.Init(center, hasHyper, hasJump);
+	
+	shared_ptr<Routes> result = make_shared<Routes>();
+	result->systems = Routes::allSystems;
+	result->distance.resize(result->systems->list.size(), -1);
+	result->next.resize(result->systems->list.size(), -1);
+	for(const auto &it : search.distance)
+	{
+		int index = result->Index(it.first);
+		if(index >= 0)
+			result->distance[index] = it.second;
+	}
+	for(const auto &it : search.route)
+	{
+		int index = result->Index(it.first);
+		if(index >= 0)
+			result->next[index] = result->Index(it.second);
+	}
+	cached = result;
+	return cached;
+}
+
+
+
+// Check what travel capabilities the given ship has. If no ship is given,
+// assume hyperdrive capability and no jump drive.
+void DistanceMap::Capabilities(const Ship *ship, bool &hasHyper, bool &hasJump)
+{
+	hasHyper = ship ? ship->Attributes().Get("hyperdrive") : true;
+	hasJump = ship ? ship->Attributes().Get("jump drive") : false;
+	// If the ship has no jump capability, do pathfinding as if it has a
+	// hyperdrive. The Ship class still won't let it jump, though.
+	hasHyper |= !(hasHyper | hasJump);
+}
+
+
+
+// Use hyperspace paths, jump drive paths, or both to find the shortest
+// route. Bail out if the source system or the maximum count is reached.
+void DistanceMap::Init(const System *center, bool hasHyper, bool hasJump)
 {
 	if(!center)
 		return;
@@ -135,14 +295,6 @@ void DistanceMap::Init(const System *center, const Ship *ship)
 	if(!maxDistance)
 		return;
 	
-	// Check what travel capabilities this ship has. If no ship is given, assume
-	// hyperdrive capability and no jump drive.
-	bool hasHyper = ship ? ship->Attributes().Get("hyperdrive") : true;
-	bool hasJump = ship ? ship->Attributes().Get("jump drive") : false;
-	// If the ship has no jump capability, do pathfinding as if it has a
-	// hyperdrive. The Ship class still won't let it jump, though.
-	hasHyper |= !(hasHyper | hasJump);
-	
 	edge.emplace(0, center);
 	while(maxCount && !edge.empty())
 	{
@@ -162,7 +314,7 @@ void DistanceMap::Init(const System *center, const Ship *ship)
 				{
 					// If we're seeking a path toward a "source," travel through
 					// wormholes in the reverse of the normal direction.
-					const System *link = source ?
+					const System *link = reverseWormholes ?
 						object.GetPlanet()->WormholeSource(system) :
 						object.GetPlanet()->WormholeDestination(system);
 					if(HasBetter(link, steps))
@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #define DISTANCE_MAP_H_
 
 #include <map>
+#include <memory>
 #include <queue>
 #include <utility>
 
@@ -27,7 +28,10 @@ class PlayerInfo;
 // from the given "center" system. Ships with a hyperdrive travel using the
 // "links" between systems. Ships with jump drives can make use of those links,
 // but can also travel to any of a system's "neighbors." A distance map can also
-// be used to calculate the shortest route between two systems.
+// be used to calculate the shortest route between two systems. Maps that are
+// not limited in size and do not depend on what the player knows are cached,
+// so a full search from each system is only done once for each combination
+// of travel capabilities.
 class DistanceMap {
 public:
 	// Find paths to the given system. If the given maximum count is above zero,
@@ -59,12 +63,26 @@ public:
 	// Access the distance map directly.
 	const std::map<const System *, int> Distances() const;
 	
+	// Discard all the cached maps. This must be done whenever a hyperspace
+	// link, a wormhole, or the list of systems changes.
+	static void ClearCache();
+	
+	// A map stored in the cache. This is only defined in DistanceMap.cpp.
+	class Routes;
+	
 	
 private:
-	// Depending on the capabilities of the given ship, use hyperspace paths,
-	// jump drive paths, or both to find the shortest route. Bail out if the
-	// source system or the maximum count is reached.
-	void Init(const System *center, const Ship *ship = nullptr);
+	DistanceMap() = default;
+	// Get the cached map from the given center, searching from it if it is
+	// not in the cache yet. If "toCenter" is set, the routes lead toward the
+	// center instead of away from it, and may travel through wormholes.
+	static std::shared_ptr<const Routes> Cached(const System *center, bool hasHyper, bool hasJump, bool toCenter);
+	// Check what travel capabilities the given ship has. If no ship is given,
+	// assume hyperdrive capability and no jump drive.
+	static void Capabilities(const Ship *ship, bool &hasHyper, bool &hasJump);
+	// Use hyperspace paths, jump drive paths, or both to find the shortest
+	// route. Bail out if the source system or the maximum count is reached.
+	void Init(const System *center, bool hasHyper, bool hasJump);
 	// Add the given links to the map. Return false if an end condition is hit.
 	bool Propagate(const System *system, bool useJump, int steps);
 	// Check if we already have a better path to the given system.
@@ -80,6 +98,8 @@ private:
 private:
 	std::map<const System *, int> distance;
 	std::map<const System *, const System *> route;
+	// If this map came from the cache, it is stored here instead.
+	std::shared_ptr<const Routes> routes;
 	
 	// Variables only used during construction:
 	std::priority_queue<std::pair<int, const System *>> edge;
@@ -88,6 +108,9 @@ private:
 	int maxCount = -1;
 	int maxDistance = -1;
 	bool useWormholes = true;
+	// Whether wormholes should be traveled in reverse, because the search is
+	// for routes toward the center.
+	bool reverseWormholes = false;
 };
 
 
@@ -19,10 +19,19 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "SpriteSet.h"
 #include "SpriteShader.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace std;
 
+namespace {
+	// Marker for the end of a batch's list of items.
+	const uint32_t NONE = ~0u;
+	// How many of the most recent batches to check when looking for one that a
+	// new item can be added to.
+	const size_t LOOKBACK = 16;
+}
+
 
 
 // Default constructor.
@@ -59,8 +68,8 @@ bool DrawList::Add(const Animation &animation, Point pos, Point unit, Point blur
 		return false;
 	if(topLeft.X() > Screen::Right() || topLeft.Y() > Screen::Bottom())
 		return false;
-		
-	items.emplace_back(animation, pos, unit, blur, clip, step);
+	
+	items.emplace_back(animation, pos, unit, blur, clip, step, topLeft, bottomRight);
 	return true;
 }
 
@@ -89,21 +98,75 @@ bool DrawList::Add(const Sprite *sprite, Point pos, Point unit, Point blur, doub
 void DrawList::Draw() const
 {
 	bool showBlur = Preferences::Has("Render motion blur");
+	MakeBatches();
 	SpriteShader::Bind();
+	
+	for(const Batch &batch : batches)
+	{
+		instances.resize(batch.count * SpriteShader::INSTANCE_SIZE);
+		float *out = instances.data();
+		for(uint32_t i = batch.first; i != NONE; i = next[i])
+		{
+			const Item &item = items[i];
+			out = copy(item.Position(), item.Position() + 2, out);
+			out = copy(item.Transform(), item.Transform() + 4, out);
+			if(showBlur)
+				out = copy(item.Blur(), item.Blur() + 2, out);
+			else
+				out = fill_n(out, 2, 0.f);
+			*out++ = item.Clip();
+			*out++ = batch.tex1 ? item.Fade() : 0.f;
+		}
+		SpriteShader::AddBatch(batch.tex0, batch.tex1, batch.swizzle, instances.data(), batch.count);
+	}
+	
+	SpriteShader::Unbind();
+}
 
-	for(const Item &item : items)
-		SpriteShader::Add(item.Texture0(), item.Texture1(),
-			item.Position(), item.Transform(),
-			item.Swizzle(), item.Clip(), item.Fade(), showBlur ? item.Blur() : nullptr);
 
-	SpriteShader::Unbind();
+
+// Sort the items into batches that can each be drawn in a single call.
+void DrawList::MakeBatches() const
+{
+	batches.clear();
+	next.assign(items.size(), NONE);
+	
+	for(uint32_t i = 0; i < items.size(); ++i)
+	{
+		const Item &item = items[i];
+		// Look for a recent batch that this item can be added to. Adding it to
+		// a batch means drawing it before any batches that come after that one,
+		// so that is only allowed if it does not overlap any of them.
+		Batch *target = nullptr;
+		size_t stop = batches.size() - min(batches.size(), LOOKBACK);
+		for(size_t j = batches.size(); j > stop; --j)
+		{
+			Batch &batch = batches[j - 1];
+			if(batch.Matches(item))
+			{
+				target = &batch;
+				break;
+			}
+			if(batch.Overlaps(item))
+				break;
+		}
+		if(target)
+		{
+			next[target->last] = i;
+			target->Add(item, i);
+		}
+		else
+			batches.emplace_back(item, i);
+	}
 }
 
 
 
-DrawList::Item::Item(const Animation &animation, Point pos, Point unit, Point blur, float clip, int step)
+DrawList::Item::Item(const Animation &animation, Point pos, Point unit, Point blur, float clip, int step, Point topLeft, Point bottomRight)
 	: position{static_cast<float>(pos.X()), static_cast<float>(pos.Y())},
-	clip(clip), flags(animation.GetSwizzle())
+	clip(clip), flags(animation.GetSwizzle()),
+	bounds{static_cast<float>(topLeft.X()), static_cast<float>(topLeft.Y()),
+		static_cast<float>(bottomRight.X()), static_cast<float>(bottomRight.Y())}
 {
 	Animation::Frame frame = animation.Get(step);
 	tex0 = frame.first;
@@ -206,9 +269,59 @@ float DrawList::Item::Fade() const
 
 
 
+// Get the (left, top, right, bottom) bounding box of this sprite.
+const float *DrawList::Item::Bounds() const
+{
+	return bounds;
+}
+
+
+
 void DrawList::Item::Cloak(double cloak)
 {
 	tex1 = SpriteSet::Get("ship/cloaked")->Texture();
 	flags &= 0xFF;
 	flags |= static_cast<uint32_t>(cloak * 256.f) << 8;
 }
+
+
+
+DrawList::Batch::Batch(const Item &item, uint32_t index)
+	: tex0(item.Texture0()), tex1(item.Fade() ? item.Texture1() : 0), swizzle(item.Swizzle()),
+	bounds{item.Bounds()[0], item.Bounds()[1], item.Bounds()[2], item.Bounds()[3]},
+	first(index), last(index), count(1)
+{
+}
+
+
+
+// Check if the given item can be drawn as part of this batch.
+bool DrawList::Batch::Matches(const Item &item) const
+{
+	return (item.Texture0() == tex0 && (item.Fade() ? item.Texture1() : 0) == tex1
+		&& item.Swizzle() == swizzle);
+}
+
+
+
+// Check if the given item might overlap any of the items in this batch.
+bool DrawList::Batch::Overlaps(const Item &item) const
+{
+	const float *other = item.Bounds();
+	return (other[0] <= bounds[2] && other[2] >= bounds[0]
+		&& other[1] <= bounds[3] && other[3] >= bounds[1]);
+}
+
+
+
+// Add an item to the end of this batch.
+void DrawList::Batch::Add(const Item &item, uint32_t index)
+{
+	const float *other = item.Bounds();
+	bounds[0] = min(bounds[0], other[0]);
+	bounds[1] = min(bounds[1], other[1]);
+	bounds[2] = max(bounds[2], other[2]);
+	bounds[3] = max(bounds[3], other[3]);
+	last = index;
+	++count;
+}
@@ -28,6 +28,11 @@ class Sprite;
 // thread from the graphics thread. However, the SpriteShader class is also
 // available for drawing individual sprites in contexts where putting them into
 // a DrawList first does not make sense.
+//
+// Consecutive sprites that use the same textures are drawn in one instanced
+// batch. A sprite may also be moved earlier, to join an earlier batch, but only
+// if it does not overlap anything that was added between that batch and it, so
+// the order in which the sprites are drawn never makes any visible difference.
 class DrawList {
 public:
 	// Default constructor.
@@ -47,11 +52,16 @@ public:
 	void Draw() const;
 	
 	
+private:
+	// Sort the items into batches that can each be drawn in a single call.
+	void MakeBatches() const;
+	
+	
 private:
 	class Item {
 	public:
 		Item() = default;
-		Item(const Animation &animation, Point pos, Point unit, Point blur, float clip, int step);
+		Item(const Animation &animation, Point pos, Point unit, Point blur, float clip, int step, Point topLeft, Point bottomRight);
 		
 		// Get the texture of this sprite.
 		uint32_t Texture0() const;
@@ -71,6 +81,9 @@ private:
 		float Clip() const;
 		float Fade() const;
 		
+		// Get the (left, top, right, bottom) bounding box of this sprite.
+		const float *Bounds() const;
+		
 		void Cloak(double cloak);
 		
 	private:
@@ -81,12 +94,40 @@ private:
 		float blur[2];
 		float clip;
 		uint32_t flags;
+		float bounds[4];
+	};
+	
+	// A batch is a list of items that all use the same textures and swizzle.
+	class Batch {
+	public:
+		Batch(const Item &item, uint32_t index);
+		
+		// Check if the given item can be drawn as part of this batch.
+		bool Matches(const Item &item) const;
+		// Check if the given item might overlap any of the items in this batch.
+		bool Overlaps(const Item &item) const;
+		// Add an item to the end of this batch.
+		void Add(const Item &item, uint32_t index);
+		
+		uint32_t tex0;
+		uint32_t tex1;
+		uint32_t swizzle;
+		float bounds[4];
+		// Each batch is a linked list of items, stored in the "next" vector.
+		uint32_t first;
+		uint32_t last;
+		int count;
 	};
 	
 	
 private:
 	int step;
 	std::vector<Item> items;
+	
+	// Scratch space for drawing the items in batches.
+	mutable std::vector<Batch> batches;
+	mutable std::vector<uint32_t> next;
+	mutable std::vector<float> instances;
 };
 
 
@@ -16,12 +16,24 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "DataNode.h"
 #include "Random.h"
 
+#include <set>
+
 using namespace std;
 
+namespace {
+	// Get a string that will never move, and that has the same contents as the
+	// given one.
+	const string *Intern(const string &name)
+	{
+		static set<string> names;
+		return &*names.insert(name).first;
+	}
+}
+
 
 
 Effect::Effect()
-	: sound(nullptr), velocityScale(1.), randomVelocity(0.),
+	: name(Intern("")), sound(nullptr), velocityScale(1.), randomVelocity(0.),
 	randomAngle(0.), randomSpin(0.), randomFrameRate(0.), lifetime(0)
 {
 }
@@ -30,7 +42,7 @@ Effect::Effect()
 
 const string &Effect::Name() const
 {
-	return name;
+	return *name;
 }
 
 
@@ -38,7 +50,7 @@ const string &Effect::Name() const
 void Effect::Load(const DataNode &node)
 {
 	if(node.Size() > 1)
-		name = node.Token(1);
+		name = Intern(node.Token(1));
 	
 	for(const DataNode &child : node)
 	{
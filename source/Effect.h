@@ -48,7 +48,9 @@ public:
 	
 	
 private:
-	std::string name;
+	// New effects are made by copying an existing one, so the name is stored
+	// elsewhere rather than being copied along with it.
+	const std::string *name;
 	
 	Animation animation;
 	const Sound *sound;
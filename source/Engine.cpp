@@ -15,6 +15,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Audio.h"
 #include "Effect.h"
 #include "FillShader.h"
+#include "Fleet.h"
 #include "Font.h"
 #include "FontSet.h"
 #include "Format.h"
@@ -42,10 +43,22 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 using namespace std;
 
+namespace {
+	// Find out how far from its center a ship's anti-missile systems can reach.
+	double AntiMissileRange(const Ship &ship)
+	{
+		double range = 0.;
+		for(const Armament::Weapon &weapon : ship.Weapons())
+			if(weapon.IsAntiMissile())
+				range = max(range, weapon.GetPoint().Length() + weapon.GetOutfit()->Velocity());
+		return range;
+	}
+}
+
 
 
 Engine::Engine(PlayerInfo &player)
-	: player(player)
+	: player(player), shipCollisions(256u, 32u), antiMissileCollisions(256u, 32u)
 {
 	// Start the thread for doing calculations.
 	calcThread = thread(&Engine::ThreadEntryPoint, this);
@@ -53,10 +66,11 @@ Engine::Engine(PlayerInfo &player)
 	if(!player.IsLoaded() || !player.GetSystem())
 		return;
 	
-	// Preload any landscapes for this system.
-	for(const StellarObject &object : player.GetSystem()->Objects())
-		if(object.GetPlanet())
-			GameData::Preload(object.GetPlanet()->Landscape());
+	// Preload the landscapes and other sprites for this system, and the sprites
+	// of the player's own ships.
+	GameData::Preload(player.GetSystem());
+	for(const shared_ptr<Ship> &ship : player.Ships())
+		GameData::Preload(ship->GetSprite().GetSprite());
 	
 	// Now we know the player's current position. Draw the planets.
 	Point center;
@@ -492,6 +506,33 @@ const list<ShipEvent> &Engine::Events() const
 
 
 
+// Add a fleet to the player's system, already "in action." This is for
+// setting up benchmark scenarios.
+void Engine::AddFleet(const Fleet &fleet)
+{
+	if(player.GetSystem())
+		fleet.Place(*player.GetSystem(), ships);
+}
+
+
+
+// Do the calculations for the next step in the calling thread, without
+// waiting for it to be drawn, and record how many seconds each phase of the
+// step took. This is for benchmarking, and must not be mixed with Go().
+void Engine::StepHeadless(vector<double> &phaseTimes)
+{
+	++step;
+	phaseTimes.assign(PHASE_COUNT, 0.);
+	this->phaseTimes = &phaseTimes;
+	phaseTimer = FrameTimer();
+	
+	CalculateStep();
+	
+	this->phaseTimes = nullptr;
+}
+
+
+
 // Draw a frame.
 void Engine::Draw() const
 {
@@ -642,9 +683,7 @@ void Engine::EnterSystem()
 		+ today.ToString() + (system->IsInhabited() ?
 			"." : ". No inhabited planets detected."));
 	
-	for(const StellarObject &object : system->Objects())
-		if(object.GetPlanet())
-			GameData::Preload(object.GetPlanet()->Landscape());
+	GameData::Preload(system);
 	
 	GameData::SetDate(today);
 	GameData::StepEconomy();
@@ -746,14 +785,20 @@ void Engine::CalculateStep()
 		return;
 	
 	// Now, all the ships must decide what they are doing next.
-	ai.Step(ships, player);
+	registry.Update(ships);
+	ai.Step(registry, player);
+	Mark(AI_PHASE);
 	const Ship *flagship = player.Flagship();
 	bool wasHyperspacing = (flagship && flagship->IsEnteringHyperspace());
 	
 	// Now, move all the ships. We must finish moving all of them before any of
 	// them fire, or their turrets will be targeting where a given ship was
 	// instead of where it is now. This is also where ships get deleted, and
-	// where they may create explosions if they are dying.
+	// where they may create explosions if they are dying. Each ship gets its
+	// own stream of random numbers for this step, keyed by its place in the
+	// list, so what it does does not depend on the order ships are moved in.
+	RandomStream random = Random::Stream();
+	uint64_t index = 0;
 	for(auto it = ships.begin(); it != ships.end(); )
 	{
 		int hyperspaceType = (*it)->HyperspaceType();
@@ -763,7 +808,7 @@ void Engine::CalculateStep()
 		// create explosions. Eventually ships might create other effects too.
 		// Note that engine flares are handled separately, so that they will be
 		// drawn immediately under the ship.
-		if(!(*it)->Move(effects))
+		if(!(*it)->Move(effects, random.Stream(index++)))
 			it = ships.erase(it);
 		else
 		{
@@ -809,6 +854,7 @@ void Engine::CalculateStep()
 		player.SetSystem(flagship->GetSystem());
 		EnterSystem();
 	}
+	Mark(MOVE_PHASE);
 	
 	// Now we know the player's current position. Draw the planets.
 	Point centerVelocity;
@@ -883,11 +929,15 @@ void Engine::CalculateStep()
 			(system == targetSystem) ? Radar::SPECIAL : Radar::INACTIVE,
 			system->Position() - player.GetSystem()->Position());
 	
+	Mark(DRAW_PHASE);
+	
 	// Now that the planets have been drawn, we can draw the asteroids on top
 	// of them. This could be done later, as long as it is done before the
 	// collision detection.
 	asteroids.Step();
+	Mark(MOVE_PHASE);
 	asteroids.Draw(draw[calcTickTock], center, centerVelocity);
+	Mark(DRAW_PHASE);
 	
 	// Move existing projectiles. Do this before ships fire, which will create
 	// new projectiles, since those should just stay where they are created for
@@ -895,18 +945,22 @@ void Engine::CalculateStep()
 	// result in a "die" effect or a sub-munition being created. We could not
 	// move the projectiles before this because some of them are homing and need
 	// to know the current positions of the ships.
-	list<Projectile> newProjectiles;
-	for(auto it = projectiles.begin(); it != projectiles.end(); )
+	auto live = projectiles.begin();
+	for(auto it = projectiles.begin(); it != projectiles.end(); ++it)
 	{
 		if(!it->Move(effects))
-		{
 			it->MakeSubmunitions(newProjectiles);
-			it = projectiles.erase(it);
-		}
 		else
-			++it;
+		{
+			if(live != it)
+				*live = move(*it);
+			++live;
+		}
 	}
-	projectiles.splice(projectiles.end(), newProjectiles);
+	projectiles.erase(live, projectiles.end());
+	projectiles.insert(projectiles.end(), newProjectiles.begin(), newProjectiles.end());
+	newProjectiles.clear();
+	Mark(MOVE_PHASE);
 	
 	// Keep track of the relative strength of each government in this system. Do
 	// not add more ships to make a winning team even stronger. This is mostly
@@ -916,14 +970,13 @@ void Engine::CalculateStep()
 	// Now, ships fire new projectiles, which includes launching fighters. If an
 	// anti-missile system is ready to fire, it does not actually fire unless a
 	// missile is detected in range during collision detection, below.
-	vector<Ship *> hasAntiMissile;
+	antiMissileCollisions.Clear();
 	double clickRange = 50.;
 	const Ship *previousTarget = nullptr;
 	const Ship *clickTarget = nullptr;
 	if(player.Flagship() && player.Flagship()->GetTargetShip())
 		previousTarget = &*player.Flagship()->GetTargetShip();
 	
-	bool showFlagship = false;
 	for(shared_ptr<Ship> &ship : ships)
 		if(ship->GetSystem() == player.GetSystem())
 		{
@@ -934,7 +987,7 @@ void Engine::CalculateStep()
 			// its system was null to mark that it was not active.
 			ship->Launch(ships);
 			if(ship->Fire(projectiles, effects))
-				hasAntiMissile.push_back(ship.get());
+				antiMissileCollisions.Add(*ship, ship->Position(), AntiMissileRange(*ship));
 			
 			int scan = ship->Scan();
 			if(scan)
@@ -944,25 +997,11 @@ void Engine::CalculateStep()
 					eventQueue.emplace_back(ship, target, scan);
 			}
 			
-			// This is a good opportunity to draw all the ships in system.
+			// Ships that have no sprite cannot be seen or clicked on.
 			if(ship->GetSprite().IsEmpty())
 				continue;
 			
 			Point position = ship->Position() - center;
-			// Draw the flagship separately, on top of everything else.
-			if(ship.get() != flagship)
-			{
-				AddSprites(*ship, position, ship->Velocity() - centerVelocity);
-				if(ship->IsThrusting())
-				{
-					for(const auto &it : ship->Attributes().FlareSounds())
-						if(it.second > 0)
-							Audio::Play(it.first, ship->Position());
-				}
-			}
-			else
-				showFlagship = true;
-			
 			// Do not show cloaked ships on the radar, except the player's ships.
 			bool isPlayer = ship->GetGovernment()->IsPlayer();
 			if(ship->Cloaking() == 1. && !isPlayer)
@@ -996,6 +1035,30 @@ void Engine::CalculateStep()
 				position,
 				sqrt(ship->GetSprite().Width() + ship->GetSprite().Height()) * .1 + .5);
 		}
+	if(clickTarget && clickTarget == previousTarget)
+		clickCommands |= Command::BOARD;
+	antiMissileCollisions.Finish();
+	Mark(FIRE_PHASE);
+	
+	// Draw all the ships in this system.
+	bool showFlagship = false;
+	for(shared_ptr<Ship> &ship : ships)
+		if(ship->GetSystem() == player.GetSystem() && !ship->GetSprite().IsEmpty())
+		{
+			// Draw the flagship separately, on top of everything else.
+			if(ship.get() != flagship)
+			{
+				AddSprites(*ship, ship->Position() - center, ship->Velocity() - centerVelocity);
+				if(ship->IsThrusting())
+				{
+					for(const auto &it : ship->Attributes().FlareSounds())
+						if(it.second > 0)
+							Audio::Play(it.first, ship->Position());
+				}
+			}
+			else
+				showFlagship = true;
+		}
 	if(flagship && showFlagship)
 	{
 		AddSprites(*flagship, Point(), Point());
@@ -1006,10 +1069,20 @@ void Engine::CalculateStep()
 					Audio::Play(it.first);
 		}
 	}
-	if(clickTarget && clickTarget == previousTarget)
-		clickCommands |= Command::BOARD;
+	Mark(DRAW_PHASE);
 	
-	// Collision detection:
+	// Sort all the ships in this system into a grid, so that each projectile
+	// only needs to be checked against the ships that are near it.
+	shipCollisions.Clear();
+	for(shared_ptr<Ship> &ship : ships)
+		if(ship->GetSystem() == player.GetSystem())
+			shipCollisions.Add(*ship, ship->Position(), ship->GetSprite().GetMask(step).Radius());
+	shipCollisions.Finish();
+	
+	// Collision detection. Remember how far along its path each projectile got,
+	// so that any that hit something are only drawn up to that point.
+	vector<double> clip;
+	clip.reserve(projectiles.size());
 	for(Projectile &projectile : projectiles)
 	{
 		// The asteroids can collide with projectiles, the same as any other
@@ -1026,10 +1099,14 @@ void Engine::CalculateStep()
 			closestHit = asteroids.Collide(projectile, step, &hitVelocity);
 			// Projectiles can only collide with ships that are in the current
 			// system and are not landing, and that are hostile to this projectile.
-			for(shared_ptr<Ship> &ship : ships)
-				if(ship->GetSystem() == player.GetSystem() && !ship->IsLanding() && ship->Cloaking() < 1.)
+			// Only ships near this projectile's path (or its trigger radius)
+			// can possibly be hit by it.
+			const vector<Ship *> &nearby = shipCollisions.Line(
+				projectile.Position(), projectile.Velocity(), projectile.GetWeapon().TriggerRadius());
+			for(Ship *ship : nearby)
+				if(!ship->IsLanding() && ship->Cloaking() < 1.)
 				{
-					if(ship.get() != projectile.Target() && !gov->IsEnemy(ship->GetGovernment()))
+					if(ship != projectile.Target() && !gov->IsEnemy(ship->GetGovernment()))
 						continue;
 					
 					// This returns a value of 0 if the projectile has a trigger
@@ -1038,7 +1115,7 @@ void Engine::CalculateStep()
 					if(range < closestHit)
 					{
 						closestHit = range;
-						hit = ship;
+						hit = ship->shared_from_this();
 						hitVelocity = ship->Velocity();
 					}
 				}
@@ -1055,15 +1132,16 @@ void Engine::CalculateStep()
 			if(projectile.HasBlastRadius())
 			{
 				// Even friendly ships can be hit by the blast.
-				for(shared_ptr<Ship> &ship : ships)
-					if(ship->GetSystem() == player.GetSystem() && ship->Zoom() == 1.)
-						if(projectile.InBlastRadius(*ship, step))
-						{
-							int eventType = ship->TakeDamage(projectile, ship != hit);
-							if(eventType)
-								eventQueue.emplace_back(
-									projectile.GetGovernment(), ship, eventType);
-						}
+				const vector<Ship *> &inBlast = shipCollisions.Circle(
+					projectile.Position(), projectile.GetWeapon().BlastRadius());
+				for(Ship *ship : inBlast)
+					if(ship->Zoom() == 1. && projectile.InBlastRadius(*ship, step))
+					{
+						int eventType = ship->TakeDamage(projectile, ship != hit.get());
+						if(eventType)
+							eventQueue.emplace_back(
+								projectile.GetGovernment(), ship->shared_from_this(), eventType);
+					}
 			}
 			else if(hit)
 			{
@@ -1083,8 +1161,8 @@ void Engine::CalculateStep()
 				isEnemy ? Radar::SPECIAL : Radar::INACTIVE, projectile.Position() - center, 1.);
 			
 			// If the projectile did not hit anything, give the anti-missile
-			// systems a chance to shoot it down.
-			for(Ship *ship : hasAntiMissile)
+			// systems that are within range of it a chance to shoot it down.
+			for(Ship *ship : antiMissileCollisions.Circle(projectile.Position(), 0.))
 				if(ship == projectile.Target()
 						|| gov->IsEnemy(ship->GetGovernment())
 						|| ship->GetGovernment()->IsEnemy(gov))
@@ -1098,8 +1176,15 @@ void Engine::CalculateStep()
 			radar[calcTickTock].Add(
 				Radar::SPECIAL, projectile.Position() - center, 1.8);
 		
-		// Now, we can draw the projectile. The motion blur should be reduced
-		// depending on how much motion blur is in the sprite itself:
+		clip.push_back(closestHit);
+	}
+	Mark(COLLIDE_PHASE);
+	
+	// Now, we can draw the projectiles. The motion blur should be reduced
+	// depending on how much motion blur is in the sprite itself:
+	auto clipIt = clip.begin();
+	for(const Projectile &projectile : projectiles)
+	{
 		double innateVelocity = 2. * projectile.GetWeapon().Velocity();
 		Point relativeVelocity = projectile.Velocity() - centerVelocity
 			- projectile.Unit() * innateVelocity;
@@ -1108,24 +1193,28 @@ void Engine::CalculateStep()
 			projectile.Position() - center + .5 * projectile.Velocity(),
 			projectile.Unit(),
 			relativeVelocity,
-			closestHit);
+			*clipIt++);
 	}
 	
 	// Finally, draw all the effects, and then move them (because their motion
-	// is not dependent on anything else, and this way we do all the work on
-	// them in a single place.
-	for(auto it = effects.begin(); it != effects.end(); )
-	{
+	// is not dependent on anything else).
+	for(const Effect &effect : effects)
 		draw[calcTickTock].Add(
-			it->GetSprite(),
-			it->Position() - center,
-			it->Unit());
-		
-		if(!it->Move())
-			it = effects.erase(it);
-		else
-			++it;
-	}
+			effect.GetSprite(),
+			effect.Position() - center,
+			effect.Unit());
+	Mark(DRAW_PHASE);
+	
+	auto liveEffect = effects.begin();
+	for(auto it = effects.begin(); it != effects.end(); ++it)
+		if(it->Move())
+		{
+			if(liveEffect != it)
+				*liveEffect = move(*it);
+			++liveEffect;
+		}
+	effects.erase(liveEffect, effects.end());
+	Mark(MOVE_PHASE);
 	
 	// Add incoming ships.
 	for(const System::FleetProbability &fleet : player.GetSystem()->Fleets())
@@ -1217,6 +1306,19 @@ void Engine::CalculateStep()
 
 
 
+// Add the time since the last call to the given phase of the step, if the
+// step is being timed.
+void Engine::Mark(Phase phase)
+{
+	if(!phaseTimes)
+		return;
+	
+	(*phaseTimes)[phase] += phaseTimer.Time();
+	phaseTimer = FrameTimer();
+}
+
+
+
 void Engine::AddSprites(const Ship &ship, const Point &position, const Point &velocity)
 {
 	if(ship.IsThrusting())
@@ -15,14 +15,17 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "AI.h"
 #include "AsteroidField.h"
+#include "CollisionSet.h"
 #include "DrawList.h"
 #include "EscortDisplay.h"
+#include "FrameTimer.h"
 #include "Information.h"
 #include "Point.h"
 #include "Projectile.h"
 #include "Radar.h"
 #include "Ship.h"
 #include "ShipEvent.h"
+#include "ShipRegistry.h"
 
 #include <condition_variable>
 #include <list>
@@ -31,6 +34,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <thread>
 #include <vector>
 
+class Fleet;
 class Government;
 class Outfit;
 class PlayerInfo;
@@ -45,6 +49,11 @@ class PlayerInfo;
 // lag is too small to be detectable and means that the game can better handle
 // situations where there are many objects on screen at once.
 class Engine {
+public:
+	// The parts of each step whose running time is measured by the benchmark.
+	enum Phase {AI_PHASE, MOVE_PHASE, FIRE_PHASE, COLLIDE_PHASE, DRAW_PHASE, PHASE_COUNT};
+	
+	
 public:
 	Engine(PlayerInfo &player);
 	~Engine();
@@ -69,12 +78,23 @@ public:
 	// Select the object the player clicked on.
 	void Click(const Point &point);
 	
+	// Add a fleet to the player's system, already "in action." This is for
+	// setting up benchmark scenarios.
+	void AddFleet(const Fleet &fleet);
+	// Do the calculations for the next step in the calling thread, without
+	// waiting for it to be drawn, and record how many seconds each phase of the
+	// step took. This is for benchmarking, and must not be mixed with Go().
+	void StepHeadless(std::vector<double> &phaseTimes);
+	
 	
 private:
 	void EnterSystem();
 	
 	void ThreadEntryPoint();
 	void CalculateStep();
+	// Add the time since the last call to the given phase of the step, if the
+	// step is being timed.
+	void Mark(Phase phase);
 	void AddSprites(const Ship &ship, const Point &position, const Point &velocity);
 	
 	void DoGrudge(const std::shared_ptr<Ship> &target, const Government *attacker);
@@ -132,8 +152,15 @@ private:
 	int step = 0;
 	
 	std::list<std::shared_ptr<Ship>> ships;
-	std::list<Projectile> projectiles;
-	std::list<Effect> effects;
+	// A snapshot of the ships that are in a system, with the values that the
+	// AI checks for every pair of ships stored contiguously.
+	ShipRegistry registry;
+	// Projectiles and effects are created and destroyed by the thousands, so
+	// they are stored contiguously. Dead ones are removed by shifting the
+	// survivors down, which keeps them in the order they were created.
+	std::vector<Projectile> projectiles;
+	std::vector<Projectile> newProjectiles;
+	std::vector<Effect> effects;
 	// Keep track of which ships we have not seen for long enough that it is
 	// time to stop tracking their movements.
 	std::map<std::list<Ship>::iterator, int> forget;
@@ -144,6 +171,9 @@ private:
 	std::map<const Government *, std::weak_ptr<const Ship>> grudge;
 	
 	AsteroidField asteroids;
+	// Broad-phase collision detection for ships and for anti-missile systems.
+	CollisionSet shipCollisions;
+	CollisionSet antiMissileCollisions;
 	double flash = 0.;
 	bool doFlash = false;
 	bool doEnter = false;
@@ -155,6 +185,9 @@ private:
 	double load = 0.;
 	int loadCount = 0;
 	double loadSum = 0.;
+	
+	std::vector<double> *phaseTimes = nullptr;
+	FrameTimer phaseTimer;
 };
 
 
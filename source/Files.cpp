@@ -17,6 +17,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <SDL2/SDL.h>
 
 #if defined _WIN32
+#include <io.h>
 #include <windows.h>
 #endif
 
@@ -413,6 +414,40 @@ bool Files::Exists(const string &filePath)
 
 
 
+// Get the modification time and the size of the given file. Both are zero
+// if the file does not exist.
+time_t Files::Timestamp(const string &filePath)
+{
+#if defined _WIN32
+	struct _stat buf;
+	if(_wstat(ToUTF16(filePath).c_str(), &buf))
+		return 0;
+#else
+	struct stat buf;
+	if(stat(filePath.c_str(), &buf))
+		return 0;
+#endif
+	return buf.st_mtime;
+}
+
+
+
+size_t Files::Size(const string &filePath)
+{
+#if defined _WIN32
+	struct _stat buf;
+	if(_wstat(ToUTF16(filePath).c_str(), &buf))
+		return 0;
+#else
+	struct stat buf;
+	if(stat(filePath.c_str(), &buf))
+		return 0;
+#endif
+	return buf.st_size;
+}
+
+
+
 void Files::Copy(const string &from, const string &to)
 {
 #if defined _WIN32
@@ -508,6 +543,46 @@ void Files::Write(FILE *file, const string &data)
 
 
 
+// Write the given data to a temporary file, flush it to the disk, and then
+// rename it to the given path, so that the file is never left partly
+// written. Return false if any step fails.
+bool Files::SafeWrite(const string &path, const string &data)
+{
+	// The temporary file's name begins with a '.', so if it is left behind it
+	// will not show up in any directory listings.
+	string temp = path.substr(0, path.length() - Name(path).length()) + "." + Name(path) + ".tmp";
+	bool success = false;
+	{
+		File file(temp, true);
+		if(!file)
+			return false;
+		
+		success = (fwrite(data.data(), 1, data.size(), file) == data.size()) && !fflush(file);
+#if defined _WIN32
+		success = success && !_commit(_fileno(file));
+#else
+		success = success && !fsync(fileno(file));
+#endif
+	}
+	if(!success)
+	{
+		Delete(temp);
+		return false;
+	}
+	
+#if defined _WIN32
+	success = MoveFileExW(ToUTF16(temp).c_str(), ToUTF16(path).c_str(),
+		MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+	success = !rename(temp.c_str(), path.c_str());
+#endif
+	if(!success)
+		Delete(temp);
+	return success;
+}
+
+
+
 void Files::LogError(const string &message)
 {
 	lock_guard<mutex> lock(errorMutex);
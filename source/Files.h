@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #define FILES_H_
 
 #include <cstdio>
+#include <ctime>
 #include <string>
 #include <vector>
 
@@ -47,6 +48,10 @@ public:
 	static void RecursiveList(std::string directory, std::vector<std::string> *list);
 	
 	static bool Exists(const std::string &filePath);
+	// Get the modification time and the size of the given file. Both are zero
+	// if the file does not exist.
+	static time_t Timestamp(const std::string &filePath);
+	static size_t Size(const std::string &filePath);
 	static void Copy(const std::string &from, const std::string &to);
 	static void Delete(const std::string &filePath);
 	
@@ -59,6 +64,10 @@ public:
 	static std::string Read(FILE *file);
 	static void Write(const std::string &path, const std::string &data);
 	static void Write(FILE *file, const std::string &data);
+	// Write the given data to a temporary file, flush it to the disk, and then
+	// rename it to the given path, so that the file is never left partly
+	// written. Return false if any step fails.
+	static bool SafeWrite(const std::string &path, const std::string &data);
 	
 	static void LogError(const std::string &message);
 };
@@ -318,6 +318,16 @@ void Fleet::Place(const System &system, Ship &ship)
 
 
 
+// Begin loading the sprites of all the ships this fleet may contain.
+void Fleet::Preload() const
+{
+	for(const Variant &variant : variants)
+		for(const Ship *ship : variant.ships)
+			GameData::Preload(ship->GetSprite().GetSprite());
+}
+
+
+
 void Fleet::SetCargo(Ship *ship) const
 {
 	for(int i = 0; i < cargo; ++i)
@@ -51,6 +51,9 @@ public:
 	static void Enter(const System &system, Ship &ship);
 	static void Place(const System &system, Ship &ship);
 	
+	// Begin loading the sprites of all the ships this fleet may contain.
+	void Preload() const;
+	
 	
 private:
 	void SetCargo(Ship *ship) const;
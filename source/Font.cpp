@@ -24,28 +24,26 @@ using namespace std;
 
 namespace {
 	static bool showUnderlines = false;
+	// This changes every time showUnderlines does.
+	static int layoutGeneration = 0;
 	
 	static const char *vertexCode =
 		// "scale" maps pixel coordinates to GL coordinates (-1 to 1).
 		"uniform vec2 scale;\n"
-		// The (x, y) coordinates of the top left corner of the glyph.
+		// The offset in pixels to apply to every glyph.
 		"uniform vec2 position;\n"
-		// The glyph to draw. (ASCII value - 32).
-		"uniform int glyph;\n"
-		// Aspect ratio of rendered glyph (unity by default).
-		"uniform float aspect = 1.f;\n"
 		
-		// Inputs from the VBO.
+		// Inputs from the VBO: the pixel coordinates of each corner of a glyph,
+		// and the point in the font texture that corner maps to.
 		"in vec2 vert;\n"
 		"in vec2 corner;\n"
 		
 		// Output to the fragment shader.
 		"out vec2 texCoord;\n"
 		
-		// Pick the proper glyph out of the texture.
 		"void main() {\n"
-		"  texCoord = vec2((glyph + corner.x) / 96.f, corner.y);\n"
-		"  gl_Position = vec4((aspect * vert.x + position.x) * scale.x, (vert.y + position.y) * scale.y, 0, 1);\n"
+		"  texCoord = corner;\n"
+		"  gl_Position = vec4((vert + position) * scale, 0, 1);\n"
 		"}\n";
 	
 	static const char *fragmentCode =
@@ -70,14 +68,14 @@ namespace {
 
 
 Font::Font()
-	: texture(0), vao(0), vbo(0), height(0), space(0)
+	: texture(0), vao(0), vbo(0), height(0), space(0), glyphWidth(0.f), glyphHeight(0.f)
 {
 }
 
 
 
 Font::Font(const string &imagePath)
-	: texture(0), vao(0), vbo(0), height(0), space(0)
+	: texture(0), vao(0), vbo(0), height(0), space(0), glyphWidth(0.f), glyphHeight(0.f)
 {
 	Load(imagePath);
 }
@@ -102,61 +100,47 @@ void Font::Load(const string &imagePath)
 
 void Font::Draw(const string &str, const Point &point, const Color &color) const
 {
-	glUseProgram(shader.Object());
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, texture);
-	glBindVertexArray(vao);
-	
-	glUniform4fv(colorI, 1, color.Get());
-	
-	// Update the scale, only if the screen size has changed.
-	if(Screen::Width() != screenWidth || Screen::Height() != screenHeight)
-	{
-		screenWidth = Screen::Width();
-		screenHeight = Screen::Height();
-		GLfloat scale[2] = {2.f / screenWidth, -2.f / screenHeight};
-		glUniform2fv(scaleI, 1, scale);
-	}
-	
-	GLfloat textPos[2] = {
-		static_cast<float>(round(point.X() - 1.)),
-		static_cast<float>(round(point.Y()))};
+	scratch.clear();
+	Layout(str.c_str(), point, scratch);
+	DrawLayout(scratch, Point(), color);
+}
+
+
+
+// Add the glyphs for the given string, drawn at the given point, to a list
+// of vertices. A whole block of text laid out this way can then be drawn
+// with a single call, and the layout can be reused from frame to frame.
+void Font::Layout(const char *str, const Point &point, vector<float> &vertices) const
+{
+	float x = round(point.X() - 1.);
+	float y = round(point.Y());
 	int previous = 0;
 	bool underlineChar = false;
 	const int underscoreGlyph = max(0, min(GLYPHS - 1, '_' - 32));
 	
-	for(char c : str)
+	for( ; *str; ++str)
 	{
-		if(c == '_')
+		if(*str == '_')
 		{
 			underlineChar = showUnderlines;
 			continue;
 		}
 		
-		int glyph = max(0, min(GLYPHS - 1, c - 32));
+		int glyph = max(0, min(GLYPHS - 1, *str - 32));
 		if(!glyph)
 		{
-			textPos[0] += space;
+			x += space;
 			continue;
 		}
 		
-		glUniform1i(glyphI, glyph);
-		glUniform1f(aspectI, 1.f);
-		
-		textPos[0] += advance[previous * GLYPHS + glyph] + KERN;
-		glUniform2fv(positionI, 1, textPos);
-		
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		x += advance[previous * GLYPHS + glyph] + KERN;
+		AddGlyph(glyph, x, y, 1.f, vertices);
 		
 		if(underlineChar)
 		{
-			glUniform1i(glyphI, underscoreGlyph);
-			glUniform1f(aspectI, static_cast<float>(advance[glyph * GLYPHS] + KERN)
-				/ (advance[underscoreGlyph * GLYPHS] + KERN));
-			
-			glUniform2fv(positionI, 1, textPos);
-			
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			float aspect = static_cast<float>(advance[glyph * GLYPHS] + KERN)
+				/ (advance[underscoreGlyph * GLYPHS] + KERN);
+			AddGlyph(underscoreGlyph, x, y, aspect, vertices);
 			underlineChar = false;
 		}
 		
@@ -166,6 +150,39 @@ void Font::Draw(const string &str, const Point &point, const Color &color) const
 
 
 
+void Font::DrawLayout(const vector<float> &vertices, const Point &offset, const Color &color) const
+{
+	if(vertices.empty())
+		return;
+	
+	glUseProgram(shader.Object());
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	
+	glUniform4fv(colorI, 1, color.Get());
+	
+	// Update the scale, only if the screen size has changed.
+	if(Screen::Width() != screenWidth || Screen::Height() != screenHeight)
+	{
+		screenWidth = Screen::Width();
+		screenHeight = Screen::Height();
+		GLfloat scale[2] = {2.f / screenWidth, -2.f / screenHeight};
+		glUniform2fv(scaleI, 1, scale);
+	}
+	
+	GLfloat position[2] = {
+		static_cast<float>(round(offset.X())),
+		static_cast<float>(round(offset.Y()))};
+	glUniform2fv(positionI, 1, position);
+	
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STREAM_DRAW);
+	glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 4);
+}
+
+
+
 int Font::Width(const string &str, char after) const
 {
 	return Width(str.c_str(), after);
@@ -215,11 +232,22 @@ int Font::Space() const
 
 void Font::ShowUnderlines(bool show)
 {
+	if(show != showUnderlines)
+		++layoutGeneration;
 	showUnderlines = show;
 }
 
 
 
+// Get a number that changes whenever the way text is laid out changes, so that
+// anything that reuses a layout can tell when it must lay the text out again.
+int Font::LayoutGeneration()
+{
+	return layoutGeneration;
+}
+
+
+
 void Font::LoadTexture(ImageBuffer *image)
 {
 	glGenTextures(1, &texture);
@@ -300,27 +328,20 @@ void Font::CalculateAdvances(ImageBuffer *image)
 
 void Font::SetUpShader(float glyphW, float glyphH)
 {
-	glyphW *= .5f;
-	glyphH *= .5f;
+	glyphWidth = glyphW * .5f;
+	glyphHeight = glyphH * .5f;
 	
 	shader = Shader(vertexCode, fragmentCode);
 	glUseProgram(shader.Object());
 	
-	// Create the VAO and VBO.
+	// Create the VAO and VBO. The VBO is filled with glyphs each time text is
+	// drawn.
 	glGenVertexArrays(1, &vao);
 	glBindVertexArray(vao);
 	
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
 	
-	GLfloat vertices[] = {
-		   0.f,    0.f, 0.f, 0.f,
-		   0.f, glyphH, 0.f, 1.f,
-		glyphW,    0.f, 1.f, 0.f,
-		glyphW, glyphH, 1.f, 1.f
-	};
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-	
 	// connect the xy to the "vert" attribute of the vertex shader
 	glEnableVertexAttribArray(shader.Attrib("vert"));
 	glVertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE,
@@ -339,7 +360,27 @@ void Font::SetUpShader(float glyphW, float glyphH)
 
 	colorI = shader.Uniform("color");
 	scaleI = shader.Uniform("scale");
-	glyphI = shader.Uniform("glyph");
-	aspectI = shader.Uniform("aspect");
 	positionI = shader.Uniform("position");
 }
+
+
+
+// Add one glyph to the given vertices, scaling its width by the given
+// amount.
+void Font::AddGlyph(int glyph, float x, float y, float aspect, vector<float> &vertices) const
+{
+	float left = static_cast<float>(glyph) / GLYPHS;
+	float right = static_cast<float>(glyph + 1) / GLYPHS;
+	float width = aspect * glyphWidth;
+	
+	// Each glyph is drawn as two triangles.
+	const float quad[] = {
+		        x,               y,  left, 0.f,
+		        x, y + glyphHeight,  left, 1.f,
+		x + width,               y, right, 0.f,
+		x + width,               y, right, 0.f,
+		        x, y + glyphHeight,  left, 1.f,
+		x + width, y + glyphHeight, right, 1.f
+	};
+	vertices.insert(vertices.end(), begin(quad), end(quad));
+}
@@ -18,6 +18,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "gl_header.h"
 
 #include <string>
+#include <vector>
 
 class Color;
 class ImageBuffer;
@@ -37,6 +38,11 @@ public:
 	void Load(const std::string &imagePath);
 	
 	void Draw(const std::string &str, const Point &point, const Color &color) const;
+	// Add the glyphs for the given string, drawn at the given point, to a list
+	// of vertices. A whole block of text laid out this way can then be drawn
+	// with a single call, and the layout can be reused from frame to frame.
+	void Layout(const char *str, const Point &point, std::vector<float> &vertices) const;
+	void DrawLayout(const std::vector<float> &vertices, const Point &offset, const Color &color) const;
 	
 	int Width(const std::string &str, char after = ' ') const;
 	int Width(const char *str, char after = ' ') const;
@@ -46,12 +52,18 @@ public:
 	int Space() const;
 	
 	static void ShowUnderlines(bool show);
+	// Get a number that changes whenever the way text is laid out changes, so that
+	// anything that reuses a layout can tell when it must lay the text out again.
+	static int LayoutGeneration();
 	
 	
 private:
 	void LoadTexture(ImageBuffer *image);
 	void CalculateAdvances(ImageBuffer *image);
 	void SetUpShader(float glyphW, float glyphH);
+	// Add one glyph to the given vertices, scaling its width by the given
+	// amount.
+	void AddGlyph(int glyph, float x, float y, float aspect, std::vector<float> &vertices) const;
 	
 	
 private:
@@ -62,14 +74,16 @@ private:
 	
 	GLint colorI;
 	GLint scaleI;
-	GLint glyphI;
-	GLint aspectI;
 	GLint positionI;
 	
 	int height;
 	int space;
+	float glyphWidth;
+	float glyphHeight;
 	mutable int screenWidth;
 	mutable int screenHeight;
+	// Scratch space for laying out a string that is only drawn once.
+	mutable std::vector<float> scratch;
 	
 	static const int GLYPHS = 96;
 	int advance[GLYPHS * GLYPHS];
@@ -19,6 +19,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "DataFile.h"
 #include "DataNode.h"
 #include "DataWriter.h"
+#include "DistanceMap.h"
 #include "Effect.h"
 #include "Files.h"
 #include "FillShader.h"
@@ -29,6 +30,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Government.h"
 #include "Interface.h"
 #include "LineShader.h"
+#include "LocationFilter.h"
 #include "Mission.h"
 #include "Outfit.h"
 #include "OutlineShader.h"
@@ -46,12 +48,17 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "SpriteShader.h"
 #include "StarField.h"
 #include "StartConditions.h"
+#include "StellarObject.h"
 #include "System.h"
+#include "ThreadPool.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <map>
-#include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -97,10 +104,81 @@ namespace {
 	SpriteQueue spriteQueue;
 	
 	vector<string> sources;
-	multimap<const Sprite *, pair<string, string>> deferred;
-	multimap<const Sprite *, tuple<string, string, int>> preloaded;
+	// When running a benchmark, there is no OpenGL context to upload images to.
+	bool isHeadless = false;
 	
 	const Government *playerGovernment = nullptr;
+	
+	// The parsed data files are cached in this file in the config directory.
+	const string CACHE_NAME = "data cache";
+	// Change this whenever the binary format of a DataFile changes.
+	const uint64_t CACHE_VERSION = 2;
+	
+	// Fold the given bytes into a 64-bit FNV-1a hash.
+	void Hash(uint64_t &hash, const void *data, size_t size)
+	{
+		const unsigned char *it = reinterpret_cast<const unsigned char *>(data);
+		for(const unsigned char *end = it + size; it != end; ++it)
+			hash = (hash ^ *it) * 1099511628211ull;
+	}
+	
+	// Get a key that changes if any data file is added, removed, renamed, or
+	// modified, or if the order in which the files are loaded changes.
+	uint64_t CacheKey(const vector<string> &paths)
+	{
+		uint64_t key = 14695981039346656037ull;
+		Hash(key, &CACHE_VERSION, sizeof(CACHE_VERSION));
+		for(const string &path : paths)
+		{
+			int64_t timestamp = Files::Timestamp(path);
+			uint64_t size = Files::Size(path);
+			Hash(key, path.c_str(), path.length() + 1);
+			Hash(key, &timestamp, sizeof(timestamp));
+			Hash(key, &size, sizeof(size));
+		}
+		return key;
+	}
+	
+	// Try to read all the data files from the cache. This fails if the cache
+	// does not exist, is for a different set of files, or is corrupt.
+	bool ReadCache(uint64_t key, vector<DataFile> &data)
+	{
+		string cache = Files::Read(Files::Config() + CACHE_NAME);
+		const char *it = cache.data();
+		const char *end = it + cache.size();
+		
+		uint64_t cacheKey = 0;
+		uint64_t count = 0;
+		if(cache.size() < sizeof(cacheKey) + sizeof(count))
+			return false;
+		memcpy(&cacheKey, it, sizeof(cacheKey));
+		it += sizeof(cacheKey);
+		memcpy(&count, it, sizeof(count));
+		it += sizeof(count);
+		if(cacheKey != key || count != data.size())
+			return false;
+		
+		for(DataFile &file : data)
+			if(!file.ReadBinary(it, end))
+				return false;
+		if(it != end)
+			return false;
+		
+		// Parsing the text would have printed these warnings, so print them now.
+		for(const DataFile &file : data)
+			file.PrintWarnings();
+		return true;
+	}
+	
+	void WriteCache(uint64_t key, const vector<DataFile> &data)
+	{
+		uint64_t count = data.size();
+		string cache(reinterpret_cast<const char *>(&key), sizeof(key));
+		cache.append(reinterpret_cast<const char *>(&count), sizeof(count));
+		for(const DataFile &file : data)
+			file.WriteBinary(cache);
+		Files::Write(Files::Config() + CACHE_NAME, cache);
+	}
 }
 
 
@@ -121,6 +199,10 @@ void GameData::BeginLoad(const char * const *argv)
 				printWeapons = true;
 			if(arg == "-d" || arg == "--debug")
 				debugMode = true;
+			if(arg == "--benchmark" || arg == "--benchmark-masks")
+				isHeadless = true;
+			if(arg == "--texture-budget" && it[1])
+				spriteQueue.SetBudget(static_cast<size_t>(max(0, atoi(*++it))) << 20);
 			continue;
 		}
 	}
@@ -135,34 +217,77 @@ void GameData::BeginLoad(const char * const *argv)
 	map<string, string> images;
 	LoadImages(images);
 	
+	// Without any graphics, only the sprites' sizes and collision masks are
+	// needed, so the high-DPI versions of the images can be skipped.
+	if(isHeadless)
+		spriteQueue.SkipTextures();
+	
 	// From the name, strip out any frame number, plus the extension.
 	for(const auto &it : images)
 	{
 		string name = Name(it.first);
 		if(name.substr(0, 5) == "land/")
-			deferred.emplace(SpriteSet::Get(name), pair<string, string>(name, it.second));
-		else
+		{
+			// Landscapes are never drawn when running without any graphics.
+			if(!isHeadless)
+				spriteQueue.Defer(name, it.second);
+		}
+		else if(!isHeadless || it.first.find("@2x.") == string::npos)
 			spriteQueue.Add(name, it.second);
 	}
 	
+	// Iterate through the paths starting with the last directory given. That
+	// is, things in folders near the start of the path have the ability to
+	// override things in folders later in the path.
+	vector<string> dataFiles;
 	for(const string &source : sources)
+		for(const string &path : Files::RecursiveList(source + "data/"))
+			if(path.length() >= 4 && !path.compare(path.length() - 4, 4, ".txt"))
+				dataFiles.push_back(path);
+	
+	// If none of the files have changed since the last time the game was run,
+	// read the already parsed nodes from the cache. Otherwise, parse them and
+	// then write them to the cache for next time.
+	vector<DataFile> data(dataFiles.size());
+	uint64_t cacheKey = CacheKey(dataFiles);
+	if(!ReadCache(cacheKey, data))
 	{
-		// Iterate through the paths starting with the last directory given. That
-		// is, things in folders near the start of the path have the ability to
-		// override things in folders later in the path.
-		vector<string> dataFiles = Files::RecursiveList(source + "data/");
-		for(const string &path : dataFiles)
-			LoadFile(path, debugMode);
+		// Reading and parsing the files does not touch any of the game data, so
+		// it can be done for all of them at once. The results are still applied
+		// one file at a time in the order above, so overrides work the same way.
+		data = vector<DataFile>(dataFiles.size());
+		{
+			ThreadPool pool;
+			pool.Run(dataFiles.size(), [&dataFiles, &data](unsigned i)
+			{
+				data[i].Load(dataFiles[i]);
+			});
+		}
+		WriteCache(cacheKey, data);
 	}
+	for(unsigned i = 0; i < dataFiles.size(); ++i)
+		LoadFile(dataFiles[i], data[i], debugMode);
 	
 	// Now that all the stars are loaded, update the neighbor lists.
 	for(auto &it : systems)
 		it.second.UpdateNeighbors(systems);
+	DistanceMap::ClearCache();
+	LocationFilter::ClearIndex();
 	// And, update the ships with the outfits we've now finished loading.
 	for(auto &it : ships)
 		it.second.FinishLoading();
 	for(const auto &it : persons)
 		it.second.GetShip()->FinishLoading();
+	// The weapon totals are cached the first time they are asked for. The AI
+	// reads them from several threads at once, so fill them in now.
+	for(const auto &it : outfits)
+	{
+		it.second.ShieldDamage();
+		it.second.HullDamage();
+		it.second.HeatDamage();
+		it.second.IonDamage();
+		it.second.TotalLifetime();
+	}
 	
 	// Store the current state, to revert back to later.
 	defaultFleets = fleets;
@@ -211,47 +336,46 @@ double GameData::Progress()
 
 
 
-// Begin loading a sprite that was previously deferred. Currently this is
-// done with all landscapes to speed up the program's startup.
+// Begin loading a sprite that is likely to be needed soon. This is done with
+// all landscapes (which are not loaded at all when the game starts) and with
+// the other streamed sprites, which are loaded when they are first drawn.
 void GameData::Preload(const Sprite *sprite)
 {
-	auto loadedRange = preloaded.equal_range(sprite);
-	if(loadedRange.first != loadedRange.second)
-	{
-		int priority = get<2>(loadedRange.first->second);
-		for(auto &it : preloaded)
-			if(get<2>(it.second) < priority)
-				++get<2>(it.second);
-		for( ; loadedRange.first != loadedRange.second; ++loadedRange.first)
-			get<2>(loadedRange.first->second) = 0;
-	}
-	
-	auto range = deferred.equal_range(sprite);
-	if(range.first == range.second)
-		return;
-	
-	// Remove the oldest thing in the priority queue if it has grown big enough.
-	vector<multimap<const Sprite *, tuple<string, string, int>>::iterator> toErase;
-	for(auto it = preloaded.begin(); it != preloaded.end(); ++it)
-		if(++get<2>(it->second) >= 20)
-			toErase.push_back(it);
-	while(!toErase.empty())
-	{
-		const auto &next = *toErase.back();
-		deferred.emplace(next.first, make_pair(get<0>(next.second), get<1>(next.second)));
-		spriteQueue.Unload(get<0>(toErase.back()->second));
-		preloaded.erase(toErase.back());
-		toErase.pop_back();
-	}
-	
-	// Load this new sprite.
-	for(auto it = range.first; it != range.second; ++it)
+	spriteQueue.Preload(sprite);
+}
+
+
+
+// Begin loading the sprites of everything that is likely to be seen in the
+// given system: its stellar objects, their landscapes, and its fleets' ships.
+void GameData::Preload(const System *system)
+{
+	for(const StellarObject &object : system->Objects())
 	{
-		spriteQueue.Add(it->second.first, it->second.second);
-		preloaded.emplace(sprite, make_tuple(it->second.first, it->second.second, 0));
+		Preload(object.GetSprite().GetSprite());
+		if(object.GetPlanet())
+			Preload(object.GetPlanet()->Landscape());
 	}
-	
-	deferred.erase(range.first, range.second);
+	for(const System::FleetProbability &fleet : system->Fleets())
+		fleet.Get()->Preload();
+}
+
+
+
+// Upload any streamed sprites that have finished loading, and unload the ones
+// that have not been used recently if they are taking up too much memory.
+void GameData::UpdateSprites()
+{
+	spriteQueue.Update();
+}
+
+
+
+// Get a summary of how quickly the sprites were loaded, and how well the
+// streamed sprites have been loaded in time.
+string GameData::SpriteStatistics()
+{
+	return spriteQueue.Throughput() + "\n" + spriteQueue.Statistics();
 }
 
 
@@ -289,6 +413,8 @@ void GameData::Revert()
 	for(auto &it : persons)
 		it.second.GetShip()->Restore();
 	
+	DistanceMap::ClearCache();
+	LocationFilter::ClearIndex();
 	politics.Reset();
 	purchases.clear();
 }
@@ -387,21 +513,47 @@ void GameData::StepEconomy()
 	
 	// Finally, send out the trade goods. This has to be done in a separate step
 	// because otherwise whichever systems trade last would already have gotten
-	// supplied by the other systems.
+	// supplied by the other systems. First, number the systems and store all
+	// the links in one list, with each system's links in a contiguous block.
+	vector<System *> list;
+	unordered_map<const System *, int> index;
 	for(auto &it : systems)
 	{
-		System &system = it.second;
-		if(system.Links().size())
-			for(const Trade::Commodity &commodity : trade.Commodities())
+		index[&it.second] = list.size();
+		list.push_back(&it.second);
+	}
+	vector<int> begin(1, 0);
+	vector<int> links;
+	vector<double> scale(list.size());
+	for(unsigned i = 0; i < list.size(); ++i)
+	{
+		// Each system's exports are split evenly between all its links.
+		scale[i] = list[i]->Links().size();
+		for(const System *neighbor : list[i]->Links())
+		{
+			auto it = index.find(neighbor);
+			if(it != index.end())
+				links.push_back(it->second);
+		}
+		begin.push_back(links.size());
+	}
+	
+	// Then, for each commodity, add up what each system receives from its
+	// neighbors.
+	vector<double> exports(list.size());
+	for(const Trade::Commodity &commodity : trade.Commodities())
+	{
+		int id = System::CommodityIndex(commodity.name);
+		for(unsigned i = 0; i < list.size(); ++i)
+			exports[i] = scale[i] ? list[i]->Exports(id) / scale[i] : 0.;
+		
+		for(unsigned i = 0; i < list.size(); ++i)
+			if(!list[i]->Links().empty())
 			{
-				double supply = system.Supply(commodity.name);
-				for(const System *neighbor : system.Links())
-				{
-					double scale = neighbor->Links().size();
-					if(scale)
-						supply += neighbor->Exports(commodity.name) / scale;
-				}
-				system.SetSupply(commodity.name, supply);
+				double supply = list[i]->Supply(id);
+				for(int j = begin[i]; j < begin[i + 1]; ++j)
+					supply += exports[links[j]];
+				list[i]->SetSupply(id, supply);
 			}
 	}
 }
@@ -421,7 +573,10 @@ void GameData::Change(const DataNode &node)
 	if(node.Token(0) == "fleet" && node.Size() >= 2)
 		fleets.Get(node.Token(1))->Load(node);
 	else if(node.Token(0) == "government" && node.Size() >= 2)
+	{
 		governments.Get(node.Token(1))->Load(node);
+		politics.UpdateRelations();
+	}
 	else if(node.Token(0) == "outfitter" && node.Size() >= 2)
 		outfitSales.Get(node.Token(1))->Load(node, outfits);
 	else if(node.Token(0) == "planet" && node.Size() >= 2)
@@ -434,6 +589,16 @@ void GameData::Change(const DataNode &node)
 		systems.Get(node.Token(1))->Link(systems.Get(node.Token(2)));
 	else if(node.Token(0) == "unlink" && node.Size() >= 3)
 		systems.Get(node.Token(1))->Unlink(systems.Get(node.Token(2)));
+	
+	// Any change to a system or a planet may have changed the hyperspace links,
+	// the wormholes, or which planets are where, so the cached routes and the
+	// index of planets are no longer valid.
+	if(node.Token(0) == "link" || node.Token(0) == "unlink"
+			|| node.Token(0) == "system" || node.Token(0) == "planet")
+	{
+		DistanceMap::ClearCache();
+		LocationFilter::ClearIndex();
+	}
 }
 
 
@@ -609,13 +774,8 @@ void GameData::LoadSources()
 
 
 
-void GameData::LoadFile(const string &path, bool debugMode)
+void GameData::LoadFile(const string &path, const DataFile &data, bool debugMode)
 {
-	// This is an ordinary file. Check to see if it is an image.
-	if(path.length() < 4 || path.compare(path.length() - 4, 4, ".txt"))
-		return;
-	
-	DataFile data(path);
 	if(debugMode)
 		Files::LogError("Parsing: " + path);
 	
@@ -697,6 +857,8 @@ void GameData::LoadImage(const string &path, map<string, string> &images, size_t
 
 
 
+// Get the name of the sprite that the image at the given path (relative to
+// the images folder) belongs to, stripping any frame number and "@2x".
 string GameData::Name(const string &path)
 {
 	// The path always ends in a three-letter extension, ".png" or ".jpg".
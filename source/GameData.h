@@ -22,6 +22,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 class Color;
 class Conversation;
+class DataFile;
 class DataNode;
 class DataWriter;
 class Date;
@@ -56,10 +57,20 @@ public:
 	static void BeginLoad(const char * const *argv);
 	static void LoadShaders();
 	static double Progress();
-	// Begin loading a sprite that was previously deferred. Currently this is
-	// done with all landscapes to speed up the program's startup.
+	// Begin loading a sprite that is likely to be needed soon. This is done with
+	// all landscapes (which are not loaded at all when the game starts) and with
+	// the other streamed sprites, which are loaded when they are first drawn.
 	static void Preload(const Sprite *sprite);
+	// Begin loading the sprites of everything that is likely to be seen in the
+	// given system: its stellar objects, their landscapes, and its fleets' ships.
+	static void Preload(const System *system);
 	static void FinishLoading();
+	// Upload any streamed sprites that have finished loading, and unload the ones
+	// that have not been used recently if they are taking up too much memory.
+	static void UpdateSprites();
+	// Get a summary of how quickly the sprites were loaded, and how well the
+	// streamed sprites have been loaded in time.
+	static std::string SpriteStatistics();
 	
 	// Get the list of resource sources (i.e. plugin folders).
 	static const std::vector<std::string> &Sources();
@@ -100,13 +111,16 @@ public:
 	
 	static const StarField &Background();
 	
+	// Get the name of the sprite that the image at the given path (relative to
+	// the images folder) belongs to, stripping any frame number and "@2x".
+	static std::string Name(const std::string &path);
+	
 	
 private:
 	static void LoadSources();
-	static void LoadFile(const std::string &path, bool debugMode);
+	static void LoadFile(const std::string &path, const DataFile &data, bool debugMode);
 	static void LoadImages(std::map<std::string, std::string> &images);
 	static void LoadImage(const std::string &path, std::map<std::string, std::string> &images, size_t start);
-	static std::string Name(const std::string &path);
 	
 	static void PrintShipTable();
 	static void PrintWeaponTable();
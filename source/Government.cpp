@@ -123,6 +123,15 @@ const string &Government::GetName() const
 
 
 
+// Get this government's index. Governments are numbered consecutively,
+// starting from zero, in the order they were created.
+unsigned Government::Index() const
+{
+	return id;
+}
+
+
+
 // Get the color swizzle to use for ships of this government.
 int Government::GetSwizzle() const
 {
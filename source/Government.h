@@ -44,6 +44,9 @@ public:
 	
 	// Get the name of this government.
 	const std::string &GetName() const;
+	// Get this government's index. Governments are numbered consecutively,
+	// starting from zero, in the order they were created.
+	unsigned Index() const;
 	// Get the color swizzle to use for ships of this government.
 	int GetSwizzle() const;
 	// Get the color to use for displaying this government on the map.
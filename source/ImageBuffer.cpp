@@ -18,13 +18,20 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <jpeglib.h>
 
 #include <cstdio>
+#include <cstring>
 #include <vector>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 namespace {
-	ImageBuffer *ReadPNG(const string &path);
-	ImageBuffer *ReadJPG(const string &path);
+	// Read the whole file at once, with a single large read.
+	bool ReadFile(const string &path, string &data);
+	ImageBuffer *ReadPNG(const string &data);
+	ImageBuffer *ReadJPG(const string &data);
 	void Premultiply(ImageBuffer *buffer, int additive);
 }
 
@@ -93,7 +100,10 @@ uint32_t *ImageBuffer::Begin(int y)
 
 
 
-ImageBuffer *ImageBuffer::Read(const string &path)
+// Read the given image file, decoding it from memory after reading the
+// whole file at once. If "bytes" is given, the size of the file is added
+// to it.
+ImageBuffer *ImageBuffer::Read(const string &path, size_t *bytes)
 {
 	// First, make sure this is a JPG or PNG file.
 	if(path.length() < 4)
@@ -105,7 +115,13 @@ ImageBuffer *ImageBuffer::Read(const string &path)
 	if(!isPNG && !isJPG)
 		return nullptr;
 	
-	ImageBuffer *buffer = isPNG ? ReadPNG(path) : ReadJPG(path);
+	string data;
+	if(!ReadFile(path, data))
+		return nullptr;
+	if(bytes)
+		*bytes += data.size();
+	
+	ImageBuffer *buffer = isPNG ? ReadPNG(data) : ReadJPG(data);
 	
 	// Check if the sprite uses additive blending.
 	int pos = path.length() - 4;
@@ -128,13 +144,47 @@ ImageBuffer *ImageBuffer::Read(const string &path)
 
 
 namespace {
-	ImageBuffer *ReadPNG(const string &path)
+	// The part of a file that libpng has not read yet.
+	class Source {
+	public:
+		const char *next;
+		size_t remaining;
+	};
+	
+	
+	void ReadSource(png_struct *png, png_byte *data, png_size_t length)
+	{
+		Source *source = reinterpret_cast<Source *>(png_get_io_ptr(png));
+		if(length > source->remaining)
+			png_error(png, "Unexpected end of file.");
+		
+		memcpy(data, source->next, length);
+		source->next += length;
+		source->remaining -= length;
+	}
+	
+	
+	
+	bool ReadFile(const string &path, string &data)
 	{
-		// Open the file, and make sure it really is a PNG.
 		File file(path);
 		if(!file)
-			return nullptr;
+			return false;
+		
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		if(size <= 0)
+			return false;
 		
+		data.resize(size);
+		return (fread(&data[0], 1, data.size(), file) == data.size());
+	}
+	
+	
+	
+	ImageBuffer *ReadPNG(const string &data)
+	{
 		// Set up libpng.
 		png_struct *png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
 		if(!png)
@@ -155,7 +205,8 @@ namespace {
 			return nullptr;
 		}
 		
-		png_init_io(png, file);
+		Source source = {data.data(), data.size()};
+		png_set_read_fn(png, &source, ReadSource);
 		png_set_sig_bytes(png, 0);
 		
 		png_read_info(png, info);
@@ -186,7 +237,7 @@ namespace {
 		
 		png_read_image(png, &rows.front());
 		
-		// Clean up. The file will be closed automatically.
+		// Clean up.
 		png_destroy_read_struct(&png, &info, nullptr);
 		
 		return buffer;
@@ -194,18 +245,16 @@ namespace {
 	
 	
 	
-	ImageBuffer *ReadJPG(const string &path)
+	ImageBuffer *ReadJPG(const string &data)
 	{
-		File file(path);
-		if(!file)
-			return nullptr;
-		
 		jpeg_decompress_struct cinfo;
 		struct jpeg_error_mgr jerr;
 		cinfo.err = jpeg_std_error(&jerr);
 		jpeg_create_decompress(&cinfo);
 		
-		jpeg_stdio_src(&cinfo, file);
+		// Older versions of libjpeg take a non-const pointer, but do not
+		// modify the data.
+		jpeg_mem_src(&cinfo, reinterpret_cast<unsigned char *>(const_cast<char *>(data.data())), data.size());
 		jpeg_read_header(&cinfo, true);
 		cinfo.out_color_space = JCS_EXT_BGRA;
 		
@@ -235,11 +284,42 @@ namespace {
 		if(!buffer)
 			return;
 		
+		// Each color channel becomes (channel * alpha) / 255, rounded down.
+		// The alpha is kept, reduced to a quarter for "half-additive" images,
+		// or cleared for additive ones.
+		uint32_t alphaMask = (additive == 2) ? 0 : (additive == 1) ? 0x3F000000 : 0xFF000000;
+		int alphaShift = (additive == 1) ? 2 : 0;
+#ifdef __SSE2__
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi16(1);
+		const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+		const __m128i alphaBits = _mm_set1_epi32(alphaMask);
+		const __m128i shift = _mm_cvtsi32_si128(alphaShift);
+#endif
 		for(int y = 0; y < buffer->Height(); ++y)
 		{
 			uint32_t *it = buffer->Begin(y);
-			
-			for(uint32_t *end = it + buffer->Width(); it != end; ++it)
+			uint32_t *end = it + buffer->Width();
+#ifdef __SSE2__
+			// Do four pixels at a time, with each channel widened to 16 bits.
+			// For any product of two channels, x / 255 == (x + 1 + (x >> 8)) >> 8.
+			for( ; it + 4 <= end; it += 4)
+			{
+				__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(it));
+				__m128i low = _mm_unpacklo_epi8(value, zero);
+				__m128i high = _mm_unpackhi_epi8(value, zero);
+				__m128i lowAlpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(low, 0xFF), 0xFF);
+				__m128i highAlpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(high, 0xFF), 0xFF);
+				low = _mm_mullo_epi16(low, lowAlpha);
+				high = _mm_mullo_epi16(high, highAlpha);
+				low = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(low, one), _mm_srli_epi16(low, 8)), 8);
+				high = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(high, one), _mm_srli_epi16(high, 8)), 8);
+				__m128i color = _mm_and_si128(_mm_packus_epi16(low, high), colorMask);
+				__m128i alpha = _mm_and_si128(_mm_srl_epi32(value, shift), alphaBits);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(it), _mm_or_si128(color, alpha));
+			}
+#endif
+			for( ; it != end; ++it)
 			{
 				uint64_t value = *it;
 				uint64_t alpha = (value & 0xFF000000) >> 24;
@@ -249,12 +329,7 @@ namespace {
 				uint64_t blue = (((value & 0xFF) * alpha) / 255) & 0xFF;
 				
 				value = red | green | blue;
-				if(additive == 1)
-					alpha >>= 2;
-				if(additive != 2)
-					value |= (alpha << 24);
-				
-				*it = static_cast<uint32_t>(value);
+				*it = static_cast<uint32_t>(value | ((*it >> alphaShift) & alphaMask));
 			}
 		}
 	}
@@ -13,6 +13,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef IMAGE_BUFFER_H_
 #define IMAGE_BUFFER_H_
 
+#include <cstddef>
 #include <string>
 
 
@@ -41,7 +42,10 @@ public:
 	const uint32_t *Begin(int y) const;
 	uint32_t *Begin(int y);
 	
-	static ImageBuffer *Read(const std::string &path);
+	// Read the given image file, decoding it from memory after reading the
+	// whole file at once. If "bytes" is given, the size of the file is added
+	// to it.
+	static ImageBuffer *Read(const std::string &path, size_t *bytes = nullptr);
 	
 	
 private:
@@ -47,6 +47,9 @@ LoadPanel::LoadPanel(PlayerInfo &player, UI &gamePanels)
 	// game is paused, i.e. the "main panel" is not on top:
 	if(player.GetPlanet() && !player.IsDead() && !gamePanels.IsTop(&*gamePanels.Root()))
 		player.Save();
+	// Saves are written in the background, so make sure all of them are on
+	// disk before listing or copying them.
+	PlayerInfo::FinishSaving();
 	UpdateLists();
 }
 
@@ -21,6 +21,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Ship.h"
 #include "System.h"
 
+#include <algorithm>
+#include <iterator>
+#include <map>
 #include <mutex>
 
 using namespace std;
@@ -48,24 +51,118 @@ namespace {
 	// Check if the given system is within the given distance of the center.
 	int Distance(const System *center, const System *system, int maximum)
 	{
-		// This function should only ever be called from the main thread, but
-		// just to be sure, use mutex protection on the static locals.
-		static mutex distanceMutex;
-		lock_guard<mutex> lock(distanceMutex);
+		// Unlimited distance maps are cached, so this does not do a search
+		// unless this center has never been used before.
+		int d = DistanceMap(center).Distance(system);
+		return (d > maximum) ? -1 : d;
+	}
+	
+	// An index of every planet that is in a system. Each planet is referred to
+	// by its position in GameData::Planets(), and each list of positions is
+	// sorted, so that lists can be intersected quickly.
+	class PlanetIndex {
+	public:
+		void Build();
+		// Get all the planets in systems that are within the given range of
+		// distances from the given center.
+		vector<unsigned> InRange(const System *center, int minimum, int maximum);
 		
-		static const System *previousCenter = center;
-		static DistanceMap distance(center, -1, maximum);
-		int previousMaximum = maximum;
+	public:
+		bool isBuilt = false;
+		vector<const Planet *> planets;
+		vector<unsigned> all;
+		map<const Planet *, unsigned> byPlanet;
+		map<const System *, vector<unsigned>> bySystem;
+		map<const Government *, vector<unsigned>> byGovernment;
+		map<string, vector<unsigned>> byAttribute;
+		// The systems at each distance from each center that has been used.
+		map<const System *, vector<vector<const System *>>> rings;
+	};
+	
+	// The index is only ever used from the main thread, but just to be sure,
+	// protect it with a mutex.
+	mutex indexMutex;
+	PlanetIndex planetIndex;
+	
+	
+	
+	void PlanetIndex::Build()
+	{
+		*this = PlanetIndex();
+		isBuilt = true;
 		
-		if(center != previousCenter || maximum > previousMaximum)
+		for(const auto &it : GameData::Planets())
 		{
-			previousCenter = center;
-			previousMaximum = maximum;
-			distance = DistanceMap(center, -1, maximum);
+			unsigned index = planets.size();
+			const Planet *planet = &it.second;
+			planets.push_back(planet);
+			byPlanet[planet] = index;
+			
+			// A planet that is not in any system can never match a filter.
+			const System *system = planet->GetSystem();
+			if(!system)
+				continue;
+			
+			all.push_back(index);
+			bySystem[system].push_back(index);
+			byGovernment[system->GetGovernment()].push_back(index);
+			for(const string &attribute : planet->Attributes())
+				byAttribute[attribute].push_back(index);
 		}
-		// If the distance is greater than the maximum, this is not a match.
-		int d = distance.Distance(system);
-		return (d > maximum) ? -1 : d;
+	}
+	
+	
+	
+	// Get all the planets in systems that are within the given range of
+	// distances from the given center.
+	vector<unsigned> PlanetIndex::InRange(const System *center, int minimum, int maximum)
+	{
+		vector<vector<const System *>> &byDistance = rings[center];
+		if(byDistance.empty())
+			for(const auto &it : DistanceMap(center).Distances())
+			{
+				if(byDistance.size() <= static_cast<unsigned>(it.second))
+					byDistance.resize(it.second + 1);
+				byDistance[it.second].push_back(it.first);
+			}
+		
+		vector<unsigned> result;
+		for(int d = max(0, minimum); d <= maximum && d < static_cast<int>(byDistance.size()); ++d)
+			for(const System *system : byDistance[d])
+			{
+				auto it = bySystem.find(system);
+				if(it != bySystem.end())
+					result.insert(result.end(), it->second.begin(), it->second.end());
+			}
+		sort(result.begin(), result.end());
+		return result;
+	}
+	
+	
+	
+	// Add the given list of planets to a list that is being assembled.
+	void Append(vector<unsigned> &list, const vector<unsigned> &planets)
+	{
+		list.insert(list.end(), planets.begin(), planets.end());
+	}
+	
+	// Narrow down the list of candidates to the ones that are also in the given
+	// list. Until the first list is applied, every planet is a candidate. The
+	// given list does not need to be sorted yet.
+	void Narrow(vector<unsigned> &candidates, bool &isNarrowed, vector<unsigned> &list)
+	{
+		sort(list.begin(), list.end());
+		list.erase(unique(list.begin(), list.end()), list.end());
+		if(!isNarrowed)
+		{
+			candidates.swap(list);
+			isNarrowed = true;
+			return;
+		}
+		
+		vector<unsigned> result;
+		set_intersection(candidates.begin(), candidates.end(), list.begin(), list.end(), back_inserter(result));
+		candidates.swap(result);
 	}
 }
 
@@ -263,3 +360,87 @@ bool LocationFilter::Matches(const Ship &ship) const
 	}
 	return true;
 }
+
+
+
+// Find all the planets that match this filter, in the same order as in
+// GameData::Planets(). Rather than checking every planet, this looks up
+// the planets that meet each condition in an index and intersects them.
+vector<const Planet *> LocationFilter::MatchingPlanets(const System *origin) const
+{
+	lock_guard<mutex> lock(indexMutex);
+	if(!planetIndex.isBuilt)
+		planetIndex.Build();
+	
+	vector<unsigned> candidates;
+	bool isNarrowed = false;
+	vector<unsigned> list;
+	if(!planets.empty())
+	{
+		for(const Planet *planet : planets)
+		{
+			auto it = planetIndex.byPlanet.find(planet);
+			if(it != planetIndex.byPlanet.end() && planet->GetSystem())
+				list.push_back(it->second);
+		}
+		Narrow(candidates, isNarrowed, list);
+	}
+	if(!systems.empty())
+	{
+		list.clear();
+		for(const System *system : systems)
+		{
+			auto it = planetIndex.bySystem.find(system);
+			if(it != planetIndex.bySystem.end())
+				Append(list, it->second);
+		}
+		Narrow(candidates, isNarrowed, list);
+	}
+	if(!governments.empty())
+	{
+		list.clear();
+		for(const Government *government : governments)
+		{
+			auto it = planetIndex.byGovernment.find(government);
+			if(it != planetIndex.byGovernment.end())
+				Append(list, it->second);
+		}
+		Narrow(candidates, isNarrowed, list);
+	}
+	for(const set<string> &attr : attributes)
+	{
+		list.clear();
+		for(const string &attribute : attr)
+		{
+			auto it = planetIndex.byAttribute.find(attribute);
+			if(it != planetIndex.byAttribute.end())
+				Append(list, it->second);
+		}
+		Narrow(candidates, isNarrowed, list);
+	}
+	if(center)
+	{
+		list = planetIndex.InRange(center, centerMinDistance, centerMaxDistance);
+		Narrow(candidates, isNarrowed, list);
+	}
+	if(origin && originMaxDistance >= 0)
+	{
+		list = planetIndex.InRange(origin, originMinDistance, originMaxDistance);
+		Narrow(candidates, isNarrowed, list);
+	}
+	
+	vector<const Planet *> result;
+	for(unsigned index : (isNarrowed ? candidates : planetIndex.all))
+		result.push_back(planetIndex.planets[index]);
+	return result;
+}
+
+
+
+// Discard the index of planets. This must be done whenever a planet or a
+// system changes, or a new one is added.
+void LocationFilter::ClearIndex()
+{
+	lock_guard<mutex> lock(indexMutex);
+	planetIndex = PlanetIndex();
+}
@@ -16,6 +16,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <list>
 #include <set>
 #include <string>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -44,6 +45,14 @@ public:
 	bool Matches(const Planet *planet, const System *origin = nullptr) const;
 	bool Matches(const System *system, const System *origin = nullptr) const;
 	bool Matches(const Ship &ship) const;
+	// Find all the planets that match this filter, in the same order as in
+	// GameData::Planets(). Rather than checking every planet, this looks up
+	// the planets that meet each condition in an index and intersects them.
+	std::vector<const Planet *> MatchingPlanets(const System *origin = nullptr) const;
+	
+	// Discard the index of planets. This must be done whenever a planet or a
+	// system changes, or a new one is added.
+	static void ClearIndex();
 	
 	
 private:
@@ -18,6 +18,10 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <cmath>
 #include <limits>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 namespace {
@@ -200,13 +204,37 @@ namespace {
 	
 	
 	// Find the radius of the object.
-	double Radius(const vector<Point> &outline)
+	double FindRadius(const vector<Point> &outline)
 	{
 		double radius = 0.;
 		for(const Point &p : outline)
 			radius = max(radius, p.LengthSquared());
 		return sqrt(radius);
 	}
+	
+	
+	// Outlines with fewer vertices than this are always searched in full.
+	const unsigned MIN_INDEXED = 64;
+	// How many consecutive vertices are grouped in each leaf bounding box.
+	const unsigned LEAF_SIZE = 8;
+	
+	
+#ifdef __SSE2__
+	// Pick the values from "a" where the mask is set, and from "b" elsewhere.
+	__m128d Select(__m128d mask, __m128d a, __m128d b)
+	{
+		return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+	}
+	
+	
+	// Get the smaller of the two values in the given vector.
+	double Min(__m128d v)
+	{
+		double lanes[2];
+		_mm_storeu_pd(lanes, v);
+		return min(lanes[0], lanes[1]);
+	}
+#endif
 }
 
 
@@ -230,7 +258,33 @@ void Mask::Create(ImageBuffer *image)
 	
 	Simplify(raw, &outline);
 	
-	radius = Radius(outline);
+	radius = FindRadius(outline);
+	
+	x.clear();
+	y.clear();
+	edgeX.clear();
+	edgeY.clear();
+	boxes.clear();
+	slabX.clear();
+	slabBegin.clear();
+	slabEdges.clear();
+	if(outline.empty())
+		return;
+	
+	Point prev = outline.back();
+	x.push_back(prev.X());
+	y.push_back(prev.Y());
+	for(const Point &next : outline)
+	{
+		x.push_back(next.X());
+		y.push_back(next.Y());
+		Point edge = next - prev;
+		edgeX.push_back(edge.X());
+		edgeY.push_back(edge.Y());
+		prev = next;
+	}
+	if(outline.size() >= MIN_INDEXED)
+		Index();
 }
 
 
@@ -274,6 +328,43 @@ double Mask::Collide(Point sA, Point vA, Angle facing) const
 
 
 
+// Check several line segments against this mask at once. Each result is
+// what Collide() would return for that segment, but the segments are
+// tested against each edge of the outline side by side.
+void Mask::Collide(const Point *sA, const Point *vA, int count, Angle facing, double *result) const
+{
+	// Segments that cannot be resolved without checking every edge of the
+	// outline are saved up until there are two to check at once.
+	Angle inverse = -facing;
+	int waiting = -1;
+	Point s[2];
+	Point v[2];
+	for(int i = 0; i < count; ++i)
+	{
+		result[i] = 1.;
+		double distance = sA[i].Length();
+		if(outline.empty() || distance > radius + vA[i].Length())
+			continue;
+		
+		int slot = (waiting >= 0);
+		s[slot] = inverse.Rotate(sA[i]);
+		v[slot] = inverse.Rotate(vA[i]);
+		if(distance <= radius && Contains(s[slot]))
+			result[i] = 0.;
+		else if(waiting < 0)
+			waiting = i;
+		else
+		{
+			Intersection(s, v, &result[waiting], &result[i]);
+			waiting = -1;
+		}
+	}
+	if(waiting >= 0)
+		result[waiting] = Intersection(s[0], v[0]);
+}
+
+
+
 // Check whether the mask contains the given point.
 bool Mask::Contains(Point point, Angle facing) const
 {
@@ -299,11 +390,7 @@ bool Mask::WithinRange(Point point, Angle facing, double range) const
 	// For efficiency, compare to range^2 instead of range.
 	range *= range;
 	
-	for(const Point &p : outline)
-		if(p.DistanceSquared(point) < range)
-			return true;
-	
-	return false;
+	return (ClosestSquared(point, range) < range);
 }
 
 
@@ -312,16 +399,33 @@ bool Mask::WithinRange(Point point, Angle facing, double range) const
 double Mask::Range(Point point, Angle facing) const
 {
 	double range = numeric_limits<double>::infinity();
+	if(outline.empty())
+		return range;
 	
 	// Rotate into the mask's frame of reference.
 	point = (-facing).Rotate(point);
 	if(Contains(point))
 		return 0.;
 	
-	for(const Point &p : outline)
-		range = min(range, p.Distance(point));
-	
-	return range;
+	// Find the closest vertex by comparing squared distances, and only take
+	// the square root of the closest one.
+	return sqrt(ClosestSquared(point, range));
+}
+
+
+
+// Get the maximum distance from the center of this mask to its outline.
+double Mask::Radius() const
+{
+	return radius;
+}
+
+
+
+// Get the vertices of the outline.
+const vector<Point> &Mask::Outline() const
+{
+	return outline;
 }
 
 
@@ -331,33 +435,92 @@ double Mask::Intersection(Point sA, Point vA) const
 	// Keep track of the closest intersection point found.
 	double closest = 1.;
 	
-	Point prev = outline.back();
-	for(const Point &next : outline)
+	// Check if there is an intersection with each edge. (If not, the cross
+	// would be 0.) If there is, handle it only if it is a point where the
+	// segment is entering the polygon rather than exiting it (i.e. cross > 0).
+	// If the intersection occurs somewhere within the edge, find out how far
+	// along the query vector it occurs and remember it if it is the closest.
+	unsigned size = edgeX.size();
+	unsigned i = 0;
+#ifdef __SSE2__
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d one = _mm_set1_pd(1.);
+	const __m128d sX = _mm_set1_pd(sA.X());
+	const __m128d sY = _mm_set1_pd(sA.Y());
+	const __m128d aX = _mm_set1_pd(vA.X());
+	const __m128d aY = _mm_set1_pd(vA.Y());
+	__m128d best = one;
+	for( ; i + 2 <= size; i += 2)
+	{
+		__m128d bX = _mm_loadu_pd(&edgeX[i]);
+		__m128d bY = _mm_loadu_pd(&edgeY[i]);
+		__m128d cross = _mm_sub_pd(_mm_mul_pd(bX, aY), _mm_mul_pd(bY, aX));
+		__m128d dX = _mm_sub_pd(_mm_loadu_pd(&x[i]), sX);
+		__m128d dY = _mm_sub_pd(_mm_loadu_pd(&y[i]), sY);
+		__m128d uB = _mm_sub_pd(_mm_mul_pd(aX, dY), _mm_mul_pd(aY, dX));
+		__m128d uA = _mm_sub_pd(_mm_mul_pd(bX, dY), _mm_mul_pd(bY, dX));
+		__m128d hit = _mm_and_pd(
+			_mm_and_pd(_mm_cmpgt_pd(cross, zero), _mm_cmpge_pd(uB, zero)),
+			_mm_and_pd(_mm_cmplt_pd(uB, cross), _mm_cmpge_pd(uA, zero)));
+		best = _mm_min_pd(best, Select(hit, _mm_div_pd(uA, cross), one));
+	}
+	closest = Min(best);
+#endif
+	for( ; i < size; ++i)
 	{
-		// Check if there is an intersection. (If not, the cross would be 0.) If
-		// there is, handle it only if it is a point where the segment is
-		// entering the polygon rather than exiting it (i.e. cross > 0).
-		Point vB = next - prev;
-		double cross = vB.Cross(vA);
+		double cross = edgeX[i] * vA.Y() - edgeY[i] * vA.X();
 		if(cross > 0.)
 		{
-			Point vS = prev - sA;
-			double uB = vA.Cross(vS);
-			double uA = vB.Cross(vS);
-			// If the intersection occurs somewhere within this segment of the
-			// outline, find out how far along the query vector it occurs and
-			// remember it if it is the closest so far.
+			double dX = x[i] - sA.X();
+			double dY = y[i] - sA.Y();
+			double uB = vA.X() * dY - vA.Y() * dX;
+			double uA = edgeX[i] * dY - edgeY[i] * dX;
 			if((uB >= 0.) & (uB < cross) & (uA >= 0.))
 				closest = min(closest, uA / cross);
 		}
-		
-		prev = next;
 	}
 	return closest;
 }
 
 
 
+// Find the intersections of two line segments with the outline at once.
+void Mask::Intersection(const Point *sA, const Point *vA, double *first, double *second) const
+{
+#ifdef __SSE2__
+	// This is the same test as above, but each half of each vector holds the
+	// values for one of the segments, and the edges are tested one at a time.
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d one = _mm_set1_pd(1.);
+	const __m128d sX = _mm_set_pd(sA[1].X(), sA[0].X());
+	const __m128d sY = _mm_set_pd(sA[1].Y(), sA[0].Y());
+	const __m128d aX = _mm_set_pd(vA[1].X(), vA[0].X());
+	const __m128d aY = _mm_set_pd(vA[1].Y(), vA[0].Y());
+	__m128d best = one;
+	for(unsigned i = 0; i < edgeX.size(); ++i)
+	{
+		__m128d bX = _mm_set1_pd(edgeX[i]);
+		__m128d bY = _mm_set1_pd(edgeY[i]);
+		__m128d cross = _mm_sub_pd(_mm_mul_pd(bX, aY), _mm_mul_pd(bY, aX));
+		__m128d dX = _mm_sub_pd(_mm_set1_pd(x[i]), sX);
+		__m128d dY = _mm_sub_pd(_mm_set1_pd(y[i]), sY);
+		__m128d uB = _mm_sub_pd(_mm_mul_pd(aX, dY), _mm_mul_pd(aY, dX));
+		__m128d uA = _mm_sub_pd(_mm_mul_pd(bX, dY), _mm_mul_pd(bY, dX));
+		__m128d hit = _mm_and_pd(
+			_mm_and_pd(_mm_cmpgt_pd(cross, zero), _mm_cmpge_pd(uB, zero)),
+			_mm_and_pd(_mm_cmplt_pd(uB, cross), _mm_cmpge_pd(uA, zero)));
+		best = _mm_min_pd(best, Select(hit, _mm_div_pd(uA, cross), one));
+	}
+	_mm_storel_pd(first, best);
+	_mm_storeh_pd(second, best);
+#else
+	*first = Intersection(sA[0], vA[0]);
+	*second = Intersection(sA[1], vA[1]);
+#endif
+}
+
+
+
 bool Mask::Contains(Point point) const
 {
 	// If this point is contained within the mask, a ray drawn out from it will
@@ -366,20 +529,192 @@ bool Mask::Contains(Point point) const
 	// open at the end to avoid double-counting.
 	
 	// For simplicity, use a ray pointing straight downwards. A segment then
-	// intersects only if its x coordinates span the point's coordinates.
+	// intersects only if its x coordinates span the point's coordinates. Only
+	// whether the number of intersections is odd matters, so just flip a bit
+	// for each one.
 	int intersections = 0;
-	Point prev = outline.back();
-	for(const Point &next : outline)
+	if(!slabX.empty())
+	{
+		// Only the edges that cross the slab this point is in can intersect.
+		// If the point is outside all the slabs, it is outside the mask.
+		auto it = upper_bound(slabX.begin(), slabX.end(), point.X());
+		if(it == slabX.begin() || it == slabX.end())
+			return false;
+		
+		unsigned slab = (it - slabX.begin()) - 1;
+		for(unsigned j = slabBegin[slab]; j < slabBegin[slab + 1]; ++j)
+		{
+			unsigned i = slabEdges[j];
+			double height = y[i] + edgeY[i] * (point.X() - x[i]) / edgeX[i];
+			intersections ^= (height >= point.Y());
+		}
+		return intersections;
+	}
+	
+	unsigned size = edgeX.size();
+	unsigned i = 0;
+#ifdef __SSE2__
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d pX = _mm_set1_pd(point.X());
+	const __m128d pY = _mm_set1_pd(point.Y());
+	int bits = 0;
+	for( ; i + 2 <= size; i += 2)
 	{
-		if(prev.X() != next.X())
-			if((prev.X() <= point.X()) == (point.X() < next.X()))
+		__m128d prevX = _mm_loadu_pd(&x[i]);
+		__m128d nextX = _mm_loadu_pd(&x[i + 1]);
+		__m128d bX = _mm_loadu_pd(&edgeX[i]);
+		__m128d bY = _mm_loadu_pd(&edgeY[i]);
+		// The edge spans the point if exactly one of these is false.
+		__m128d spans = _mm_xor_pd(_mm_cmple_pd(prevX, pX), _mm_cmplt_pd(pX, nextX));
+		__m128d height = _mm_add_pd(_mm_loadu_pd(&y[i]),
+			_mm_div_pd(_mm_mul_pd(bY, _mm_sub_pd(pX, prevX)), bX));
+		__m128d hit = _mm_andnot_pd(spans,
+			_mm_and_pd(_mm_cmpneq_pd(bX, zero), _mm_cmpge_pd(height, pY)));
+		bits ^= _mm_movemask_pd(hit);
+	}
+	intersections = (bits ^ (bits >> 1));
+#endif
+	for( ; i < size; ++i)
+		if(x[i] != x[i + 1])
+			if((x[i] <= point.X()) == (point.X() < x[i + 1]))
 			{
-				double y = prev.Y() + (next.Y() - prev.Y()) *
-					(point.X() - prev.X()) / (next.X() - prev.X());
-				intersections += (y >= point.Y());
+				double height = y[i] + edgeY[i] * (point.X() - x[i]) / edgeX[i];
+				intersections ^= (height >= point.Y());
 			}
-		prev = next;
-	}
 	// If the number of intersections is odd, the point is within the mask.
 	return (intersections & 1);
 }
+
+
+
+// Build the search structures for a long outline.
+void Mask::Index()
+{
+	// Group the vertices into leaves, in the order they appear along the
+	// outline, so each leaf covers a short stretch of it.
+	unsigned size = edgeX.size();
+	unsigned leaves = 1;
+	while(leaves * LEAF_SIZE < size)
+		leaves *= 2;
+	double inf = numeric_limits<double>::infinity();
+	boxes.assign(2 * leaves, Box{inf, inf, -inf, -inf});
+	for(unsigned i = 0; i < size; ++i)
+	{
+		Box &box = boxes[leaves + i / LEAF_SIZE];
+		box.minX = min(box.minX, x[i]);
+		box.minY = min(box.minY, y[i]);
+		box.maxX = max(box.maxX, x[i]);
+		box.maxY = max(box.maxY, y[i]);
+	}
+	for(unsigned i = leaves - 1; i; --i)
+	{
+		const Box &a = boxes[2 * i];
+		const Box &b = boxes[2 * i + 1];
+		boxes[i] = Box{min(a.minX, b.minX), min(a.minY, b.minY), max(a.maxX, b.maxX), max(a.maxY, b.maxY)};
+	}
+	
+	// Divide the mask into slabs at every vertex's x coordinate, and list the
+	// edges that cross each slab. Vertical edges do not cross any slab.
+	slabX.assign(x.begin(), x.begin() + size);
+	sort(slabX.begin(), slabX.end());
+	slabX.erase(unique(slabX.begin(), slabX.end()), slabX.end());
+	vector<unsigned> count(slabX.size(), 0);
+	for(int pass = 0; pass < 2; ++pass)
+	{
+		for(unsigned i = 0; i < size; ++i)
+			if(x[i] != x[i + 1])
+			{
+				unsigned first = lower_bound(slabX.begin(), slabX.end(), min(x[i], x[i + 1])) - slabX.begin();
+				unsigned last = lower_bound(slabX.begin(), slabX.end(), max(x[i], x[i + 1])) - slabX.begin();
+				for(unsigned slab = first; slab < last; ++slab)
+				{
+					if(pass)
+						slabEdges[count[slab]++] = i;
+					else
+						++count[slab];
+				}
+			}
+		if(pass)
+			break;
+		
+		// Now that the size of each slab's list is known, lay them out.
+		slabBegin.assign(1, 0);
+		for(unsigned &slab : count)
+		{
+			slabBegin.push_back(slabBegin.back() + slab);
+			slab = slabBegin[slabBegin.size() - 2];
+		}
+		slabEdges.resize(slabBegin.back());
+	}
+}
+
+
+
+// Find the smallest squared distance from the given point to any vertex
+// of the outline, or return the given limit if none are closer than that.
+double Mask::ClosestSquared(Point point, double limit) const
+{
+	if(boxes.empty())
+		return ClosestSquared(point, 0, edgeX.size(), limit);
+	
+	// Descend into the closer child first, and skip any box that cannot
+	// contain a vertex closer than the closest one found so far.
+	unsigned leaves = boxes.size() / 2;
+	unsigned stack[64];
+	unsigned depth = 0;
+	stack[depth++] = 1;
+	while(depth)
+	{
+		unsigned node = stack[--depth];
+		const Box &box = boxes[node];
+		double dX = max(0., max(box.minX - point.X(), point.X() - box.maxX));
+		double dY = max(0., max(box.minY - point.Y(), point.Y() - box.maxY));
+		if(dX * dX + dY * dY >= limit)
+			continue;
+		
+		if(node >= leaves)
+		{
+			unsigned first = (node - leaves) * LEAF_SIZE;
+			limit = ClosestSquared(point, first, min<unsigned>(first + LEAF_SIZE, edgeX.size()), limit);
+		}
+		else
+		{
+			const Box &left = boxes[2 * node];
+			double leftX = point.X() - .5 * (left.minX + left.maxX);
+			double leftY = point.Y() - .5 * (left.minY + left.maxY);
+			const Box &right = boxes[2 * node + 1];
+			double rightX = point.X() - .5 * (right.minX + right.maxX);
+			double rightY = point.Y() - .5 * (right.minY + right.maxY);
+			bool leftFirst = (leftX * leftX + leftY * leftY < rightX * rightX + rightY * rightY);
+			stack[depth++] = 2 * node + leftFirst;
+			stack[depth++] = 2 * node + !leftFirst;
+		}
+	}
+	return limit;
+}
+
+
+
+double Mask::ClosestSquared(Point point, unsigned first, unsigned last, double limit) const
+{
+	unsigned i = first;
+#ifdef __SSE2__
+	const __m128d pX = _mm_set1_pd(point.X());
+	const __m128d pY = _mm_set1_pd(point.Y());
+	__m128d closest = _mm_set1_pd(limit);
+	for( ; i + 2 <= last; i += 2)
+	{
+		__m128d dX = _mm_sub_pd(_mm_loadu_pd(&x[i]), pX);
+		__m128d dY = _mm_sub_pd(_mm_loadu_pd(&y[i]), pY);
+		closest = _mm_min_pd(closest, _mm_add_pd(_mm_mul_pd(dX, dX), _mm_mul_pd(dY, dY)));
+	}
+	limit = Min(closest);
+#endif
+	for( ; i < last; ++i)
+	{
+		double dX = x[i] - point.X();
+		double dY = y[i] - point.Y();
+		limit = min(limit, dX * dX + dY * dY);
+	}
+	return limit;
+}
@@ -26,7 +26,9 @@ class ImageBuffer;
 // line segment intersects that object or if a point is within a certain distance.
 // The outline is represented in polygonal form, which allows intersection tests
 // to be done much more efficiently than if we were testing individual pixels in
-// the image itself.
+// the image itself. Long outlines also get a bounding box hierarchy and a table
+// of which edges lie above or below each x coordinate, so that range and point
+// tests on large ships only need to look at a small part of the outline.
 class Mask {
 public:
 	// Default constructor.
@@ -44,6 +46,10 @@ public:
 	// If this object contains the given point, the return value is 0. If there
 	// is no collision, the return value is 1.
 	double Collide(Point sA, Point vA, Angle facing) const;
+	// Check several line segments against this mask at once. Each result is
+	// what Collide() would return for that segment, but the segments are
+	// tested against each edge of the outline side by side.
+	void Collide(const Point *sA, const Point *vA, int count, Angle facing, double *result) const;
 	
 	// Check whether the mask contains the given point.
 	bool Contains(Point point, Angle facing) const;
@@ -55,15 +61,61 @@ public:
 	// Find out how close the given point is to the mask.
 	double Range(Point point, Angle facing) const;
 	
+	// Get the maximum distance from the center of this mask to its outline.
+	double Radius() const;
+	
+	// Get the vertices of the outline.
+	const std::vector<Point> &Outline() const;
+	
 	
 private:
 	double Intersection(Point sA, Point vA) const;
+	// Find the intersections of two line segments with the outline at once.
+	void Intersection(const Point *sA, const Point *vA, double *first, double *second) const;
 	bool Contains(Point point) const;
+	// Build the search structures for a long outline.
+	void Index();
+	// Find the smallest squared distance from the given point to any vertex
+	// of the outline, or return the given limit if none are closer than that.
+	double ClosestSquared(Point point, double limit) const;
+	double ClosestSquared(Point point, unsigned first, unsigned last, double limit) const;
+	
+	
+private:
+	class Box {
+	public:
+		double minX;
+		double minY;
+		double maxX;
+		double maxY;
+	};
 	
 	
 private:
 	std::vector<Point> outline;
+	// The outline is also stored as separate arrays of x and y coordinates, so
+	// that the edges can be tested several at a time. Edge i runs from vertex i
+	// to vertex i + 1 and its vector is precomputed; the first vertex stored is
+	// the last vertex of the outline, so there is one more vertex than edges.
+	std::vector<double> x;
+	std::vector<double> y;
+	std::vector<double> edgeX;
+	std::vector<double> edgeY;
 	double radius;
+	
+	// A complete binary tree of the bounding boxes of groups of consecutive
+	// vertices. Node 1 is the root, the children of node i are 2i and 2i + 1,
+	// and the second half of the array holds the leaves. It is empty if the
+	// outline is short enough that checking every vertex is just as fast.
+	std::vector<Box> boxes;
+	// The x coordinates of all the vertices, in sorted order, divide the mask
+	// into vertical slabs. Each slab is crossed by the same set of edges, so
+	// an upward or downward ray from any point in it crosses only those edges.
+	// The edges crossing slab i are slabEdges[slabBegin[i]] through
+	// slabEdges[slabBegin[i + 1] - 1].
+	std::vector<double> slabX;
+	std::vector<unsigned> slabBegin;
+	std::vector<unsigned> slabEdges;
 };
 
 
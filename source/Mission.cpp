@@ -959,15 +959,14 @@ const Planet *Mission::PickPlanet(const LocationFilter &filter, const PlayerInfo
 {
 	// Find a planet that satisfies the filter.
 	vector<const Planet *> options;
-	for(const auto &it : GameData::Planets())
+	for(const Planet *planet : filter.MatchingPlanets(player.GetSystem()))
 	{
 		// Skip entries with incomplete data.
-		if(it.second.Name().empty() || (clearance.empty() && !it.second.CanLand()))
+		if(planet->Name().empty() || (clearance.empty() && !planet->CanLand()))
 			continue;
-		if(it.second.IsWormhole() || !it.second.HasSpaceport())
+		if(planet->IsWormhole() || !planet->HasSpaceport())
 			continue;
-		if(filter.Matches(&it.second, player.GetSystem()))
-			options.push_back(&it.second);
+		options.push_back(planet);
 	}
 	return options.empty() ? nullptr : options[Random::Int(options.size())];
 }
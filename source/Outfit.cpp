@@ -24,6 +24,20 @@ using namespace std;
 
 namespace {
 	static const double EPS = 0.0000000001;
+	
+	// Every attribute name that has been given an index. The names are never
+	// removed, so pointers to them stay valid.
+	map<string, unsigned> &Indices()
+	{
+		static map<string, unsigned> indices;
+		return indices;
+	}
+	
+	vector<const string *> &Names()
+	{
+		static vector<const string *> names;
+		return names;
+	}
 }
 
 const vector<string> Outfit::CATEGORIES = {
@@ -40,6 +54,32 @@ const vector<string> Outfit::CATEGORIES = {
 
 
 
+// Get the index of the attribute with the given name, or the name of the
+// attribute with the given index. Indices are never reused, so they can
+// be looked up once and stored in a constant.
+unsigned Outfit::Index(const string &attribute)
+{
+	// Check for an existing index first, so looking up a known name never
+	// modifies the map.
+	auto it = Indices().find(attribute);
+	if(it != Indices().end())
+		return it->second;
+	
+	it = Indices().emplace(attribute, Names().size()).first;
+	Names().push_back(&it->first);
+	return it->second;
+}
+
+
+
+const string &Outfit::Name(unsigned index)
+{
+	static const string EMPTY;
+	return (index < Names().size() ? *Names()[index] : EMPTY);
+}
+
+
+
 void Outfit::Load(const DataNode &node)
 {
 	if(node.Size() >= 2)
@@ -68,7 +108,7 @@ void Outfit::Load(const DataNode &node)
 			description += '\n';
 		}
 		else if(child.Size() >= 2)
-			attributes[child.Token(0)] = child.Value(1);
+			Set(child.Token(0), child.Value(1));
 		else
 			child.PrintTrace("Skipping unrecognized attribute:");
 	}
@@ -150,11 +190,7 @@ int Outfit::CanAdd(const Outfit &other, int count) const
 void Outfit::Add(const Outfit &other, int count)
 {
 	for(const auto &at : other.attributes)
-	{
-		attributes[at.first] += at.second * count;
-		if(fabs(attributes[at.first]) < EPS)
-			attributes[at.first] = 0.;
-	}
+		Add(at.first, at.second * count);
 	
 	for(const auto &it : other.flareSprites)
 	{
@@ -179,9 +215,8 @@ void Outfit::Add(const Outfit &other, int count)
 // Modify this outfit's attributes.
 void Outfit::Add(const string &attribute, double value)
 {
-	attributes[attribute] += value;
-	if(fabs(attributes[attribute]) < EPS)
-		attributes[attribute] = 0.;
+	value += Get(attribute);
+	Set(attribute, (fabs(value) < EPS) ? 0. : value);
 }
 
 
@@ -189,7 +224,7 @@ void Outfit::Add(const string &attribute, double value)
 // Modify this outfit's attributes.
 void Outfit::Reset(const string &attribute, double value)
 {
-	attributes[attribute] = value;
+	Set(attribute, value);
 }
 
 
@@ -214,3 +249,16 @@ const map<const Effect *, int> &Outfit::AfterburnerEffects() const
 {
 	return afterburnerEffects;
 }
+
+
+
+// Set the given attribute's value in both the map and the dense array.
+void Outfit::Set(const string &attribute, double value)
+{
+	attributes[attribute] = value;
+	
+	unsigned index = Index(attribute);
+	if(values.size() <= index)
+		values.resize(index + 1, 0.);
+	values[index] = value;
+}
@@ -33,13 +33,21 @@ class Sprite;
 // can add to or subtract from any of those values. Weapons also have another
 // set of attributes unique to them, and outfits can also specify additional
 // information like the sprite to use in the outfitter panel for selling them,
-// or the sprite or sound to be used for an engine flare.
+// or the sprite or sound to be used for an engine flare. Every attribute name
+// is also given a permanent index, so code that checks the same attribute
+// every frame can look it up in a dense array instead of searching by name.
 class Outfit : public Weapon {
 public:
 	// These are all the possible category strings for outfits.
 	static const std::vector<std::string> CATEGORIES;
 	
 public:
+	// Get the index of the attribute with the given name, or the name of the
+	// attribute with the given index. Indices are never reused, so they can
+	// be looked up once and stored in a constant.
+	static unsigned Index(const std::string &attribute);
+	static const std::string &Name(unsigned index);
+	
 	// An "outfit" can be loaded from an "outfit" node or from a ship's
 	// "attributes" node.
 	void Load(const DataNode &node);
@@ -51,6 +59,7 @@ public:
 	// Get the image to display in the outfitter when buying this item.
 	const Sprite *Thumbnail() const;
 	
+	double Get(unsigned index) const;
 	double Get(const std::string &attribute) const;
 	const std::map<std::string, double> &Attributes() const;
 	
@@ -72,6 +81,11 @@ public:
 	const std::map<const Effect *, int> &AfterburnerEffects() const;
 	
 	
+private:
+	// Set the given attribute's value in both the map and the dense array.
+	void Set(const std::string &attribute, double value);
+	
+	
 private:
 	std::string name;
 	std::string category;
@@ -79,6 +93,9 @@ private:
 	const Sprite *thumbnail = nullptr;
 	
 	std::map<std::string, double> attributes;
+	// The same values, indexed by attribute. Attributes that this outfit does
+	// not have are either zero or past the end of the array.
+	std::vector<double> values;
 	
 	std::vector<std::pair<Animation, int>> flareSprites;
 	std::map<const Sound *, int> flareSounds;
@@ -87,4 +104,12 @@ private:
 
 
 
+// Inline accessor functions, for speed:
+inline double Outfit::Get(unsigned index) const
+{
+	return (index < values.size()) ? values[index] : 0.;
+}
+
+
+
 #endif
@@ -30,15 +30,23 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Random.h"
 #include "Ship.h"
 #include "ShipEvent.h"
+#include "Sprite.h"
 #include "StartConditions.h"
 #include "System.h"
 #include "UI.h"
+#include "WriteQueue.h"
 
 #include <ctime>
 #include <sstream>
 
 using namespace std;
 
+namespace {
+	// Saved games are written to disk on a background thread, so that saving a
+	// pilot with a large fleet or a long history does not stall the game.
+	WriteQueue saveQueue;
+}
+
 
 
 // Completely clear all loaded information, to prepare for loading a file or
@@ -93,6 +101,8 @@ void PlayerInfo::Load(const string &path)
 	// Make sure any previously loaded data is cleared.
 	Clear();
 	
+	// If this file is still being saved, wait for that to finish.
+	saveQueue.Wait();
 	filePath = path;
 	DataFile file(path);
 	
@@ -252,6 +262,22 @@ void PlayerInfo::Save() const
 
 
 
+// Wait until all saves that are being written in the background are done.
+void PlayerInfo::FinishSaving()
+{
+	saveQueue.Wait();
+}
+
+
+
+// Get a summary of how long it took for saves to be written.
+string PlayerInfo::SaveStatistics()
+{
+	return saveQueue.Statistics();
+}
+
+
+
 // Get the base file name for the player, without the ".txt" extension. This
 // will usually be "<first> <last>", but may be different if multiple players
 // exist with the same name, in which case a number is appended.
@@ -1309,14 +1335,13 @@ void PlayerInfo::HandleEvent(const ShipEvent &event, UI *ui)
 // Get the value of the given condition (default 0).
 int PlayerInfo::GetCondition(const string &name) const
 {
-	auto it = conditions.find(name);
-	return (it == conditions.end()) ? 0 : it->second;
+	return conditions.Get(name);
 }
 
 
 
 // Get mutable access to the player's list of conditions.
-map<string, int> &PlayerInfo::Conditions()
+ConditionStore &PlayerInfo::Conditions()
 {
 	return conditions;
 }
@@ -1324,7 +1349,7 @@ map<string, int> &PlayerInfo::Conditions()
 
 
 // Access the player's list of conditions.
-const map<string, int> &PlayerInfo::Conditions() const
+const ConditionStore &PlayerInfo::Conditions() const
 {
 	return conditions;
 }
@@ -1625,7 +1650,22 @@ void PlayerInfo::Save(const string &path) const
 	if(!planet || !system)
 		return;
 	
-	DataWriter out(path);
+	DataWriter out;
+	
+	// Begin with a summary of this pilot, so the "Load Game" panel can read
+	// just the first few lines of the file instead of parsing all of it.
+	out.Write("summary");
+	out.BeginChild();
+	{
+		out.Write("pilot", firstName, lastName);
+		out.Write("date", date.Day(), date.Month(), date.Year());
+		out.Write("system", system->Name());
+		out.Write("planet", planet->Name());
+		out.Write("credits", accounts.Credits());
+		if(!ships.empty() && ships.front()->GetSprite().GetSprite())
+			out.Write("flagship", ships.front()->Name(), ships.front()->GetSprite().GetSprite()->Name());
+	}
+	out.EndChild();
 	
 	out.Write("pilot", firstName, lastName);
 	out.Write("date", date.Day(), date.Month(), date.Year());
@@ -1723,4 +1763,8 @@ void PlayerInfo::Save(const string &path) const
 	for(const Planet *planet : visitedPlanets)
 		if(!planet->TrueName().empty())
 			out.Write("visited planet", planet->TrueName());
+	
+	// Only converting the player's information to text must be done here.
+	// Writing it to disk can be done in the background.
+	saveQueue.Add(path, out.GetString());
 }
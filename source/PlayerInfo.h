@@ -15,6 +15,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Account.h"
 #include "CargoHold.h"
+#include "ConditionStore.h"
 #include "Date.h"
 #include "GameEvent.h"
 #include "Mission.h"
@@ -60,8 +61,13 @@ public:
 	void Load(const std::string &path);
 	// Load the most recently saved player.
 	void LoadRecent();
-	// Save this player (using the Identifier() as the file name).
+	// Save this player (using the Identifier() as the file name). The file is
+	// written to disk in the background.
 	void Save() const;
+	// Wait until all saves that are being written in the background are done.
+	static void FinishSaving();
+	// Get a summary of how long it took for saves to be written.
+	static std::string SaveStatistics();
 	
 	// Get the root filename used for this player's saved game files. (If there
 	// are multiple pilots with the same name it may have a digit appended.)
@@ -156,8 +162,8 @@ public:
 	
 	// Access the "condition" flags for this player.
 	int GetCondition(const std::string &name) const;
-	std::map<std::string, int> &Conditions();
-	const std::map<std::string, int> &Conditions() const;
+	ConditionStore &Conditions();
+	const ConditionStore &Conditions() const;
 	
 	// Check what the player knows about the given system or planet.
 	bool HasSeen(const System *system) const;
@@ -228,7 +234,7 @@ private:
 	std::shared_ptr<Ship> boardingShip;
 	std::list<Mission> doneMissions;
 	
-	std::map<std::string, int> conditions;
+	ConditionStore conditions;
 	
 	std::set<const System *> seen;
 	std::set<const System *> visitedSystems;
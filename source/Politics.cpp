@@ -42,33 +42,38 @@ void Politics::Reset()
 	// were already checked for when you first landed).
 	for(const auto &it : GameData::Governments())
 		fined.insert(&it.second);
+	
+	UpdateRelations();
 }
 
 
 
-bool Politics::IsEnemy(const Government *first, const Government *second) const
+// Recalculate which governments are enemies, because the attitudes of the
+// governments toward each other have changed.
+void Politics::UpdateRelations()
 {
-	if(first == second)
-		return false;
+	governments = 0;
+	for(const auto &it : GameData::Governments())
+		governments = max(governments, it.second.Index() + 1);
+	rowSize = (governments + 63) / 64;
+	enemies.assign(governments * rowSize, 0);
 	
-	// Just for simplicity, if one of the governments is the player, make sure
-	// it is the first one.
-	if(second->IsPlayer())
-		swap(first, second);
-	if(first->IsPlayer())
-	{
-		if(bribed.find(second) != bribed.end())
-			return false;
-		if(provoked.find(second) != provoked.end())
-			return true;
-		
-		auto it = reputationWith.find(second);
-		return (it != reputationWith.end() && it->second < 0.);
-	}
+	for(const auto &first : GameData::Governments())
+		for(const auto &second : GameData::Governments())
+			if(FindEnemy(&first.second, &second.second))
+				SetEnemy(first.second.Index(), second.second.Index(), true);
+}
+
+
+
+bool Politics::IsEnemy(const Government *first, const Government *second) const
+{
+	unsigned i = first->Index();
+	unsigned j = second->Index();
+	if(i < governments && j < governments)
+		return (enemies[i * rowSize + j / 64] >> (j % 64)) & 1;
 	
-	// Neither government is the player, so the question of enemies depends only
-	// on the attitude matrix.
-	return (first->AttitudeToward(second) < 0. || second->AttitudeToward(first) < 0.);
+	return FindEnemy(first, second);
 }
 
 
@@ -112,6 +117,7 @@ void Politics::Offend(const Government *gov, int eventType, int count)
 			reputationWith[other] -= penalty;
 		}
 	}
+	UpdatePlayer();
 }
 
 
@@ -125,6 +131,7 @@ void Politics::Bribe(const Government *gov)
 	auto it = provoked.find(gov);
 	if(it != provoked.end())
 		provoked.erase(it);
+	UpdatePlayer(gov);
 }
 
 
@@ -284,6 +291,7 @@ double Politics::Reputation(const Government *gov) const
 void Politics::AddReputation(const Government *gov, double value)
 {
 	reputationWith[gov] += value;
+	UpdatePlayer(gov);
 }
 
 
@@ -291,6 +299,7 @@ void Politics::AddReputation(const Government *gov, double value)
 void Politics::SetReputation(const Government *gov, double value)
 {
 	reputationWith[gov] = value;
+	UpdatePlayer(gov);
 }
 
 
@@ -302,4 +311,70 @@ void Politics::ResetDaily()
 	bribed.clear();
 	bribedPlanets.clear();
 	fined.clear();
+	UpdatePlayer();
+}
+
+
+
+// Check from scratch whether the given governments are enemies.
+bool Politics::FindEnemy(const Government *first, const Government *second) const
+{
+	if(first == second)
+		return false;
+	
+	// Just for simplicity, if one of the governments is the player, make sure
+	// it is the first one.
+	if(second->IsPlayer())
+		swap(first, second);
+	if(first->IsPlayer())
+	{
+		if(bribed.find(second) != bribed.end())
+			return false;
+		if(provoked.find(second) != provoked.end())
+			return true;
+		
+		auto it = reputationWith.find(second);
+		return (it != reputationWith.end() && it->second < 0.);
+	}
+	
+	// Neither government is the player, so the question of enemies depends only
+	// on the attitude matrix.
+	return (first->AttitudeToward(second) < 0. || second->AttitudeToward(first) < 0.);
+}
+
+
+
+// Update the cached relations between the player and the given government.
+void Politics::UpdatePlayer(const Government *gov)
+{
+	const Government *player = GameData::PlayerGovernment();
+	if(gov != player)
+		SetEnemy(player->Index(), gov->Index(), FindEnemy(player, gov));
+}
+
+
+
+// Update the cached relations between the player and every government.
+void Politics::UpdatePlayer()
+{
+	for(const auto &it : GameData::Governments())
+		UpdatePlayer(&it.second);
+}
+
+
+
+// Mark the given governments as being enemies or not. If either government
+// is not in the cache, do nothing.
+void Politics::SetEnemy(unsigned first, unsigned second, bool isEnemy)
+{
+	if(first >= governments || second >= governments)
+		return;
+	
+	uint64_t bit = uint64_t(1) << (second % 64);
+	uint64_t &word = enemies[first * rowSize + second / 64];
+	word = isEnemy ? (word | bit) : (word & ~bit);
+	
+	bit = uint64_t(1) << (first % 64);
+	uint64_t &other = enemies[second * rowSize + first / 64];
+	other = isEnemy ? (other | bit) : (other & ~bit);
 }
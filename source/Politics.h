@@ -13,9 +13,11 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef POLITICS_H_
 #define POLITICS_H_
 
+#include <cstdint>
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 class Government;
 class Planet;
@@ -32,6 +34,9 @@ class Politics {
 public:
 	// Reset to the initial political state defined in the game data.
 	void Reset();
+	// Recalculate which governments are enemies, because the attitudes of the
+	// governments toward each other have changed.
+	void UpdateRelations();
 	
 	bool IsEnemy(const Government *first, const Government *second) const;
 	
@@ -66,6 +71,16 @@ public:
 	void ResetDaily();
 	
 	
+private:
+	// Check from scratch whether the given governments are enemies.
+	bool FindEnemy(const Government *first, const Government *second) const;
+	// Update the cached relations between the player and the given government,
+	// or between the player and every government.
+	void UpdatePlayer(const Government *gov);
+	void UpdatePlayer();
+	void SetEnemy(unsigned first, unsigned second, bool isEnemy);
+	
+	
 private:
 	// attitude[target][other] stores how much an action toward the given target
 	// government will affect your reputation with the given other government.
@@ -78,6 +93,14 @@ private:
 	std::map<const Planet *, bool> bribedPlanets;
 	std::set<const Planet *> dominatedPlanets;
 	std::set<const Government *> fined;
+	
+	// A cache of which governments are enemies, so that checking two governments
+	// only requires testing one bit. The bit for (first, second) is bit
+	// (second % 64) of enemies[first * rowSize + second / 64]. Governments
+	// created after the cache was built fall back to checking from scratch.
+	std::vector<uint64_t> enemies;
+	unsigned governments = 0;
+	unsigned rowSize = 0;
 };
 
 
@@ -80,7 +80,7 @@ Projectile::Projectile(Point position, const Outfit *weapon)
 
 
 // This returns false if it is time to delete this projectile.
-bool Projectile::Move(list<Effect> &effects)
+bool Projectile::Move(vector<Effect> &effects)
 {
 	if(--lifetime <= 0)
 	{
@@ -185,7 +185,7 @@ bool Projectile::Move(list<Effect> &effects)
 
 // This is called when a projectile "dies," either of natural causes or
 // because it hit its target.
-void Projectile::MakeSubmunitions(list<Projectile> &projectiles) const
+void Projectile::MakeSubmunitions(vector<Projectile> &projectiles) const
 {
 	// Only make submunitions if you did *not* hit a target.
 	if(lifetime <= -100)
@@ -234,7 +234,7 @@ bool Projectile::InBlastRadius(const Ship &ship, int step) const
 
 // This projectile hit something. Create the explosion, if any. This also
 // marks the projectile as needing deletion.
-void Projectile::Explode(list<Effect> &effects, double intersection, Point hitVelocity)
+void Projectile::Explode(vector<Effect> &effects, double intersection, Point hitVelocity)
 {
 	for(const auto &it : weapon->HitEffects())
 		for(int i = 0; i < it.second; ++i)
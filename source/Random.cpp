@@ -48,6 +48,19 @@ void Random::Seed(uint64_t seed)
 
 
 
+// Create a new, independent stream of random numbers. Its key is the next
+// number from this generator, so it is reproducible as long as streams are
+// always created in the same order.
+RandomStream Random::Stream()
+{
+#ifndef __linux__
+	lock_guard<mutex> lock(workaroundMutex);
+#endif
+	return RandomStream(gen());
+}
+
+
+
 uint32_t Random::Int()
 {
 #ifndef __linux__
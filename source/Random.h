@@ -13,18 +13,25 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef RANDOM_H_
 #define RANDOM_H_
 
+#include "RandomStream.h"
+
 #include <cstdint>
 
 
 
 // Collection of functions for generating random numbers with a variety of
 // different distributions. (This is done partly because on some systems the
-// random number generation is not thread-safe.)
+// random number generation is not thread-safe.) Code that may run on several
+// threads at once should instead draw from a RandomStream of its own.
 class Random {
 public:
 	// Seed the generator (e.g. to make it produce exactly the same random
 	// numbers it produced previously).
 	static void Seed(uint64_t seed);
+	// Create a new, independent stream of random numbers. Its key is the next
+	// number from this generator, so it is reproducible as long as streams are
+	// always created in the same order.
+	static RandomStream Stream();
 	
 	static uint32_t Int();
 	static uint32_t Int(uint32_t modulus);
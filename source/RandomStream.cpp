@@ -0,0 +1,31 @@
+/* RandomStream.cpp
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "RandomStream.h"
+
+using namespace std;
+
+
+
+RandomStream::RandomStream(uint64_t seed, uint64_t id)
+	: key(Mix(seed ^ Mix(id + 0x9E3779B97F4A7C15ULL)))
+{
+}
+
+
+
+// Create a new stream whose key combines this stream's key with the given
+// id. This does not advance this stream.
+RandomStream RandomStream::Stream(uint64_t id) const
+{
+	return RandomStream(key, id);
+}
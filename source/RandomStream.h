@@ -0,0 +1,95 @@
+/* RandomStream.h
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef RANDOM_STREAM_H_
+#define RANDOM_STREAM_H_
+
+#include <cstdint>
+
+
+
+// Class representing an independent sequence of random numbers, for use by a
+// single object or subsystem. Each number is a hash of the stream's key and of
+// how many numbers have been drawn from it so far (as in SplitMix64), so a
+// stream is just two integers: creating one is cheap, no locking is needed,
+// and the numbers each stream produces do not depend on what other threads or
+// streams are doing. Streams for a set of objects can be created by combining
+// a single key with each object's index.
+class RandomStream {
+public:
+	explicit RandomStream(uint64_t seed = 0, uint64_t id = 0);
+	
+	// Create a new stream whose key combines this stream's key with the given
+	// id. This does not advance this stream.
+	RandomStream Stream(uint64_t id) const;
+	
+	// Get the next number from this stream, with the same distributions as the
+	// corresponding functions in the Random class.
+	uint64_t Next();
+	uint32_t Int();
+	uint32_t Int(uint32_t modulus);
+	double Real();
+	
+	
+private:
+	// Scramble the bits of the given value.
+	static uint64_t Mix(uint64_t value);
+	
+	
+private:
+	uint64_t key;
+	uint64_t counter = 0;
+};
+
+
+
+// Inline functions, for speed:
+inline uint64_t RandomStream::Next()
+{
+	return Mix(key + ++counter * 0x9E3779B97F4A7C15ULL);
+}
+
+
+
+inline uint32_t RandomStream::Int()
+{
+	return Next() >> 32;
+}
+
+
+
+inline uint32_t RandomStream::Int(uint32_t modulus)
+{
+	return Int() % modulus;
+}
+
+
+
+inline double RandomStream::Real()
+{
+	// Use the top 53 bits, which is as many as a double can represent, to get
+	// a number in the range [0, 1).
+	return (Next() >> 11) * (1. / 9007199254740992.);
+}
+
+
+
+inline uint64_t RandomStream::Mix(uint64_t value)
+{
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
+
+
+
+#endif
@@ -15,50 +15,72 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "DataFile.h"
 #include "DataNode.h"
 #include "Date.h"
+#include "File.h"
 #include "Format.h"
 #include "SpriteSet.h"
 
+#include <cstdio>
+#include <sstream>
+
 using namespace std;
 
+namespace {
+	// Read the "summary" block at the start of the given save file, if it has
+	// one. It must fit within the first few kilobytes of the file.
+	string ReadSummary(const string &path)
+	{
+		static const string KEY = "summary";
+		static const size_t MAX_SIZE = 4096;
+		
+		File file(path);
+		if(!file)
+			return string();
+		
+		string text(MAX_SIZE, '\0');
+		text.resize(fread(&text[0], 1, text.size(), file));
+		if(text.compare(0, KEY.length(), KEY) || text.length() <= KEY.length() || text[KEY.length()] > ' ')
+			return string();
+		
+		// The summary ends at the first line that is not indented. If that is
+		// not within the text that was read, the summary is incomplete.
+		for(size_t end = text.find('\n'); end != string::npos; end = text.find('\n', end + 1))
+			if(end + 1 < text.length() && text[end + 1] > ' ')
+				return text.substr(0, end + 1);
+		
+		return string();
+	}
+}
+
 
 
 void SavedGame::Load(const string &path)
 {
 	Clear();
-	DataFile file(path);
-	if(file.begin() != file.end())
-		this->path = path;
 	
-	for(const DataNode &node : file)
+	// The summary is only a few lines long, so if this file has one it will be
+	// within the first few kilobytes.
+	string text = ReadSummary(path);
+	if(!text.empty())
 	{
-		if(node.Token(0) == "pilot" && node.Size() >= 3)
-			name = node.Token(1) + " " + node.Token(2);
-		else if(node.Token(0) == "date" && node.Size() >= 4)
-			date = Date(node.Value(1), node.Value(2), node.Value(3)).ToString();
-		else if(node.Token(0) == "system" && node.Size() >= 2)
-			system = node.Token(1);
-		else if(node.Token(0) == "planet" && node.Size() >= 2)
-			planet = node.Token(1);
-		else if(node.Token(0) == "account")
-		{
-			for(const DataNode &child : node)
-				if(child.Token(0) == "credits" && child.Size() >= 2)
-				{
-					credits = Format::Number(child.Value(1));
-					break;
-				}
-		}
-		else if(node.Token(0) == "ship" && !shipSprite)
-		{
-			for(const DataNode &child : node)
+		istringstream in(text);
+		DataFile file(in);
+		for(const DataNode &node : file)
+			if(node.Token(0) == "summary")
 			{
-				if(child.Token(0) == "name" && child.Size() >= 2)
-					shipName = child.Token(1);
-				else if(child.Token(0) == "sprite" && child.Size() >= 2)
-					shipSprite = SpriteSet::Get(child.Token(1));
+				this->path = path;
+				for(const DataNode &child : node)
+					Read(child);
+				return;
 			}
-		}
 	}
+	
+	// Older saves do not have a summary, so the whole file must be parsed.
+	DataFile file(path);
+	if(file.begin() != file.end())
+		this->path = path;
+	
+	for(const DataNode &node : file)
+		Read(node);
 }
 
 
@@ -140,3 +162,44 @@ const string &SavedGame::ShipName() const
 {
 	return shipName;
 }
+
+
+
+// Read the information from one node of the file or of its summary.
+void SavedGame::Read(const DataNode &node)
+{
+	if(node.Token(0) == "pilot" && node.Size() >= 3)
+		name = node.Token(1) + " " + node.Token(2);
+	else if(node.Token(0) == "date" && node.Size() >= 4)
+		date = Date(node.Value(1), node.Value(2), node.Value(3)).ToString();
+	else if(node.Token(0) == "system" && node.Size() >= 2)
+		system = node.Token(1);
+	else if(node.Token(0) == "planet" && node.Size() >= 2)
+		planet = node.Token(1);
+	else if(node.Token(0) == "credits" && node.Size() >= 2)
+		credits = Format::Number(node.Value(1));
+	else if(node.Token(0) == "flagship" && node.Size() >= 3)
+	{
+		shipName = node.Token(1);
+		shipSprite = SpriteSet::Get(node.Token(2));
+	}
+	else if(node.Token(0) == "account")
+	{
+		for(const DataNode &child : node)
+			if(child.Token(0) == "credits" && child.Size() >= 2)
+			{
+				credits = Format::Number(child.Value(1));
+				break;
+			}
+	}
+	else if(node.Token(0) == "ship" && !shipSprite)
+	{
+		for(const DataNode &child : node)
+		{
+			if(child.Token(0) == "name" && child.Size() >= 2)
+				shipName = child.Token(1);
+			else if(child.Token(0) == "sprite" && child.Size() >= 2)
+				shipSprite = SpriteSet::Get(child.Token(1));
+		}
+	}
+}
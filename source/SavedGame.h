@@ -15,6 +15,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include <string>
 
+class DataNode;
 class Sprite;
 
 
@@ -23,7 +24,8 @@ class Sprite;
 // information necessary from the file to display it in the "Load Game" panel,
 // without doing all the complicated parsing that PlayerInfo does. This is so
 // that we only need to have one PlayerInfo instance, and there does not need
-// to be logic for copying one PlayerInfo into another.
+// to be logic for copying one PlayerInfo into another. If the file begins with
+// a "summary" block, only that block is read.
 class SavedGame {
 public:
 	void Load(const std::string &path);
@@ -42,6 +44,11 @@ public:
 	const std::string &ShipName() const;
 	
 	
+private:
+	// Read the information from one node of the file or of its summary.
+	void Read(const DataNode &node);
+	
+	
 private:
 	std::string path;
 	
@@ -13,23 +13,41 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef SET_H_
 #define SET_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <map>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 
 
 // Template representing a set of named objects of a given type, where you can
 // query it for a pointer to any object and it will return one, whether or not that
 // object has been loaded yet. (This allows cyclic pointers.)
+// The objects are stored in a std::map, so pointers to them never change and
+// iterating over them always goes in alphabetical order. Lookups by name go
+// through a separate open-addressing hash table of pointers into that map.
 template<class Type>
 class Set {
 public:
+	Set() = default;
+	// The hash table points into the map, so it must be rebuilt for a copy.
+	Set(const Set &other) : data(other.data) { Reindex(); }
+	Set &operator=(const Set &other) { data = other.data; Reindex(); return *this; }
+	
 	// Allow non-const access to the owner of this set; it can hand off only
 	// const references to avoid anyone else modifying the objects.
-	Type *Get(const std::string &name) { return &data[name]; }
-	const Type *Get(const std::string &name) const { return &data[name]; }
+	Type *Get(const std::string &name) { return Find(name.data(), name.length()); }
+	const Type *Get(const std::string &name) const { return Find(name.data(), name.length()); }
+	// Look up a name without first converting it to a std::string.
+	Type *Get(const char *name) { return Find(name, strlen(name)); }
+	const Type *Get(const char *name) const { return Find(name, strlen(name)); }
 	
-	bool Has(const std::string &name) const { return (data.find(name) != data.end()); }
+	bool Has(const std::string &name) const { return Lookup(name.data(), name.length()); }
+	bool Has(const char *name) const { return Lookup(name, strlen(name)); }
 	
 	typename std::map<std::string, Type>::iterator begin() { return data.begin(); }
 	typename std::map<std::string, Type>::const_iterator begin() const { return data.begin(); }
@@ -39,10 +57,124 @@ public:
 	int size() const { return data.size(); }
 	
 	
+private:
+	typedef typename std::map<std::string, Type>::value_type Value;
+	
+	class Entry {
+	public:
+		size_t hash = 0;
+		Value *value = nullptr;
+	};
+	
+	
+private:
+	// Get the object with the given name, creating it if it does not exist.
+	Type *Find(const char *name, size_t length) const;
+	// Get the hash table entry for the given name, or null if there is none.
+	Value *Lookup(const char *name, size_t length) const;
+	// Add an object that was just created to the hash table.
+	void Insert(Value *value, size_t hash) const;
+	// Rebuild the hash table from scratch.
+	void Reindex() const;
+	
+	static size_t Hash(const char *name, size_t length);
+	
+	
 private:
 	mutable std::map<std::string, Type> data;
+	// The size of this table is always zero or a power of two, and at most half
+	// of its entries are in use, so probing for a name always ends quickly.
+	mutable std::vector<Entry> index;
 };
 
 
 
+template<class Type>
+Type *Set<Type>::Find(const char *name, size_t length) const
+{
+	Value *value = Lookup(name, length);
+	if(!value)
+	{
+		auto it = data.emplace(std::piecewise_construct,
+			std::forward_as_tuple(name, length), std::forward_as_tuple()).first;
+		value = &*it;
+		Insert(value, Hash(name, length));
+	}
+	return &value->second;
+}
+
+
+
+template<class Type>
+typename Set<Type>::Value *Set<Type>::Lookup(const char *name, size_t length) const
+{
+	if(index.empty())
+		return nullptr;
+	
+	size_t hash = Hash(name, length);
+	size_t mask = index.size() - 1;
+	for(size_t i = hash & mask; index[i].value; i = (i + 1) & mask)
+	{
+		const Entry &entry = index[i];
+		if(entry.hash == hash && !entry.value->first.compare(0, std::string::npos, name, length))
+			return entry.value;
+	}
+	return nullptr;
+}
+
+
+
+template<class Type>
+void Set<Type>::Insert(Value *value, size_t hash) const
+{
+	if(2 * data.size() > index.size())
+	{
+		Reindex();
+		return;
+	}
+	
+	size_t mask = index.size() - 1;
+	size_t i = hash & mask;
+	while(index[i].value)
+		i = (i + 1) & mask;
+	index[i].hash = hash;
+	index[i].value = value;
+}
+
+
+
+template<class Type>
+void Set<Type>::Reindex() const
+{
+	size_t size = 16;
+	while(size < 2 * data.size())
+		size *= 2;
+	index.assign(size, Entry());
+	
+	size_t mask = size - 1;
+	for(Value &value : data)
+	{
+		size_t hash = Hash(value.first.data(), value.first.length());
+		size_t i = hash & mask;
+		while(index[i].value)
+			i = (i + 1) & mask;
+		index[i].hash = hash;
+		index[i].value = &value;
+	}
+}
+
+
+
+// This is the 64-bit FNV-1a hash.
+template<class Type>
+size_t Set<Type>::Hash(const char *name, size_t length)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for(const char *end = name + length; name != end; ++name)
+		hash = (hash ^ static_cast<unsigned char>(*name)) * 1099511628211ull;
+	return static_cast<size_t>(hash);
+}
+
+
+
 #endif
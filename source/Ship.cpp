@@ -22,7 +22,6 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Phrase.h"
 #include "Planet.h"
 #include "Projectile.h"
-#include "Random.h"
 #include "ShipEvent.h"
 #include "System.h"
 
@@ -33,6 +32,47 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 using namespace std;
 
+namespace {
+	// Attributes that ships check every step, so they are looked up by index
+	// instead of by name.
+	const unsigned AFTERBURNER_ENERGY = Outfit::Index("afterburner energy");
+	const unsigned AFTERBURNER_FUEL = Outfit::Index("afterburner fuel");
+	const unsigned AFTERBURNER_HEAT = Outfit::Index("afterburner heat");
+	const unsigned AFTERBURNER_THRUST = Outfit::Index("afterburner thrust");
+	const unsigned AUTOMATON = Outfit::Index("automaton");
+	const unsigned CARGO_SCAN = Outfit::Index("cargo scan");
+	const unsigned CARGO_SPACE = Outfit::Index("cargo space");
+	const unsigned CLOAK = Outfit::Index("cloak");
+	const unsigned CLOAKING_ENERGY = Outfit::Index("cloaking energy");
+	const unsigned CLOAKING_FUEL = Outfit::Index("cloaking fuel");
+	const unsigned COOLING = Outfit::Index("cooling");
+	const unsigned DRAG = Outfit::Index("drag");
+	const unsigned ENERGY_CAPACITY = Outfit::Index("energy capacity");
+	const unsigned ENERGY_GENERATION = Outfit::Index("energy generation");
+	const unsigned FUEL_CAPACITY = Outfit::Index("fuel capacity");
+	const unsigned HEAT_DISSIPATION = Outfit::Index("heat dissipation");
+	const unsigned HEAT_GENERATION = Outfit::Index("heat generation");
+	const unsigned HULL = Outfit::Index("hull");
+	const unsigned HULL_ENERGY = Outfit::Index("hull energy");
+	const unsigned HULL_REPAIR_RATE = Outfit::Index("hull repair rate");
+	const unsigned HYPERDRIVE = Outfit::Index("hyperdrive");
+	const unsigned JUMP_DRIVE = Outfit::Index("jump drive");
+	const unsigned JUMP_SPEED = Outfit::Index("jump speed");
+	const unsigned MASS = Outfit::Index("mass");
+	const unsigned OUTFIT_SCAN = Outfit::Index("outfit scan");
+	const unsigned RAMSCOOP = Outfit::Index("ramscoop");
+	const unsigned REQUIRED_CREW = Outfit::Index("required crew");
+	const unsigned SCRAM_DRIVE = Outfit::Index("scram drive");
+	const unsigned SELF_DESTRUCT = Outfit::Index("self destruct");
+	const unsigned SHIELD_ENERGY = Outfit::Index("shield energy");
+	const unsigned SHIELD_GENERATION = Outfit::Index("shield generation");
+	const unsigned SHIELDS = Outfit::Index("shields");
+	const unsigned THRUST = Outfit::Index("thrust");
+	const unsigned TURN = Outfit::Index("turn");
+	const unsigned TURNING_ENERGY = Outfit::Index("turning energy");
+	const unsigned TURNING_HEAT = Outfit::Index("turning heat");
+}
+
 const vector<string> Ship::CATEGORIES = {
 	"Transport",
 	"Light Freighter",
@@ -267,7 +307,7 @@ void Ship::FinishLoading()
 	}
 	
 	// Different ships dissipate heat at different rates.
-	heatDissipation = baseAttributes.Get("heat dissipation");
+	heatDissipation = baseAttributes.Get(HEAT_DISSIPATION);
 	if(!heatDissipation)
 		heatDissipation = .999;
 	else
@@ -297,7 +337,7 @@ void Ship::FinishLoading()
 				armament.Add(it.first, count);
 		}
 	}
-	cargo.SetSize(attributes.Get("cargo space"));
+	cargo.SetSize(attributes.Get(CARGO_SPACE));
 	equipped.clear();
 	armament.FinishLoading();
 	
@@ -609,9 +649,12 @@ const Command &Ship::Commands() const
 
 // Move this ship. A ship may create effects as it moves, in particular if
 // it is in the process of blowing up. If this returns false, the ship
-// should be deleted.
-bool Ship::Move(list<Effect> &effects)
+// should be deleted. Any random numbers the ship needs until it next moves
+// are drawn from the given stream.
+bool Ship::Move(vector<Effect> &effects, const RandomStream &stream)
 {
+	random = stream;
+	
 	// Check if this ship has been in a different system from the player for so
 	// long that it should be "forgotten." Also eliminate ships that have no
 	// system set because they just entered a fighter bay.
@@ -619,7 +662,7 @@ bool Ship::Move(list<Effect> &effects)
 	if((!isSpecial && forget >= 1000) || !currentSystem)
 		return false;
 	isInSystem = false;
-	if(!fuel || !(attributes.Get("hyperdrive") || attributes.Get("jump drive")))
+	if(!fuel || !(attributes.Get(HYPERDRIVE) || attributes.Get(JUMP_DRIVE)))
 		hyperspaceSystem = nullptr;
 	
 	// Handle ionization effects.
@@ -631,12 +674,12 @@ bool Ship::Move(list<Effect> &effects)
 		double ion = ionization * .1;
 		while(!forget)
 		{
-			ion -= Random::Real();
+			ion -= random.Real();
 			if(ion <= 0.)
 				break;
 			
-			Point point((Random::Real() - .5) * .5 * sprite.Width(),
-				(Random::Real() - .5) * .5 * sprite.Height());
+			Point point((random.Real() - .5) * .5 * sprite.Width(),
+				(random.Real() - .5) * .5 * sprite.Height());
 			if(sprite.GetMask(0).Contains(point, Angle()))
 			{
 				effects.push_back(*effect);
@@ -657,7 +700,7 @@ bool Ship::Move(list<Effect> &effects)
 	// maximum capacity for the rest of the turn, but must be clamped to the
 	// maximum here before they gain more. This is so that, for example, a ship
 	// with no batteries but a good generator can still move.
-	energy = min(energy, attributes.Get("energy capacity"));
+	energy = min(energy, attributes.Get(ENERGY_CAPACITY));
 	
 	heat *= heatDissipation;
 	if(heat > Mass() * 100.)
@@ -665,9 +708,9 @@ bool Ship::Move(list<Effect> &effects)
 	else if(heat < Mass() * 90.)
 		isOverheated = false;
 	
-	double maxShields = attributes.Get("shields");
+	double maxShields = attributes.Get(SHIELDS);
 	shields = min(shields, maxShields);
-	double maxHull = attributes.Get("hull");
+	double maxHull = attributes.Get(HULL);
 	hull = min(hull, maxHull);
 	isDisabled = isOverheated || IsDisabled();
 	
@@ -677,13 +720,13 @@ bool Ship::Move(list<Effect> &effects)
 		// If you have a ramscoop, you recharge enough fuel to make one jump in
 		// a little less than a minute - enough to be an inconvenience without
 		// being totally aggravating.
-		if(attributes.Get("ramscoop"))
-			TransferFuel(-.03 * sqrt(attributes.Get("ramscoop")), nullptr);
+		if(attributes.Get(RAMSCOOP))
+			TransferFuel(-.03 * sqrt(attributes.Get(RAMSCOOP)), nullptr);
 		
-		energy += attributes.Get("energy generation") - ionization;
+		energy += attributes.Get(ENERGY_GENERATION) - ionization;
 		energy = max(0., energy);
-		heat += attributes.Get("heat generation");
-		heat -= attributes.Get("cooling");
+		heat += attributes.Get(HEAT_GENERATION);
+		heat -= attributes.Get(COOLING);
 		heat = max(0., heat);
 	}
 	
@@ -698,13 +741,13 @@ bool Ship::Move(list<Effect> &effects)
 				const Effect *effect = GameData::Effects().Get("smoke");
 				double scale = .015 * (sprite.Width() + sprite.Height()) + .5;
 				double radius = .1 * (sprite.Width() + sprite.Height());
-				int debrisCount = attributes.Get("mass") * .07;
+				int debrisCount = attributes.Get(MASS) * .07;
 				for(int i = 0; i < debrisCount; ++i)
 				{
 					effects.push_back(*effect);
 					
-					Angle angle = Angle::Random();
-					Point effectVelocity = velocity + angle.Unit() * (scale * Random::Real());
+					Angle angle = Angle::Random(random);
+					Point effectVelocity = velocity + angle.Unit() * (scale * random.Real());
 					Point effectPosition = position + radius * angle.Unit();
 					effects.back().Place(effectPosition, effectVelocity, angle);
 				}
@@ -722,7 +765,7 @@ bool Ship::Move(list<Effect> &effects)
 		// If the ship is dead, it first creates explosions at an increasing
 		// rate, then disappears in one big explosion.
 		++explosionRate;
-		if(Random::Int(1024) < explosionRate)
+		if(random.Int(1024) < explosionRate)
 			CreateExplosion(effects);
 	}
 	else if(hyperspaceSystem || hyperspaceCount)
@@ -747,12 +790,12 @@ bool Ship::Move(list<Effect> &effects)
 			const Effect *effect = GameData::Effects().Get("jump drive");
 			while(--count >= 0)
 			{
-				Point point((Random::Real() - .5) * .5 * sprite.Width(),
-					(Random::Real() - .5) * .5 * sprite.Height());
+				Point point((random.Real() - .5) * .5 * sprite.Width(),
+					(random.Real() - .5) * .5 * sprite.Height());
 				if(sprite.GetMask(0).Contains(point, Angle()))
 				{
 					effects.push_back(*effect);
-					Point vel = velocity + 5. * Angle::Random(360.).Unit();
+					Point vel = velocity + 5. * Angle::Random(random).Unit();
 					effects.back().Place(angle.Rotate(point) + position, vel, angle);
 				}
 			}
@@ -785,7 +828,7 @@ bool Ship::Move(list<Effect> &effects)
 			
 			if(hasJumpDrive)
 			{
-				position = target + Angle::Random().Unit() * 300. * (Random::Real() + 1.);
+				position = target + Angle::Random(random).Unit() * 300. * (random.Real() + 1.);
 				return true;
 			}
 			
@@ -870,14 +913,14 @@ bool Ship::Move(list<Effect> &effects)
 			}
 		}
 		// Only refuel if this planet has a spaceport.
-		else if(fuel == attributes.Get("fuel capacity")
+		else if(fuel == attributes.Get(FUEL_CAPACITY)
 				|| !landingPlanet || !landingPlanet->HasSpaceport())
 		{
 			zoom = min(1., zoom + .02);
 			landingPlanet = nullptr;
 		}
 		else
-			fuel = min(fuel + 1., attributes.Get("fuel capacity"));
+			fuel = min(fuel + 1., attributes.Get(FUEL_CAPACITY));
 		
 		// Move the ship at the velocity it had when it began landing, but
 		// scaled based on how small it is now.
@@ -894,15 +937,15 @@ bool Ship::Move(list<Effect> &effects)
 			hyperspaceSystem = GetTargetSystem();
 	}
 	
-	double cloakingSpeed = attributes.Get("cloak");
+	double cloakingSpeed = attributes.Get(CLOAK);
 	bool canCloak = (zoom == 1. && !isDisabled && !hyperspaceCount && cloakingSpeed
-		&& fuel >= attributes.Get("cloaking fuel")
-		&& energy >= attributes.Get("cloaking energy"));
+		&& fuel >= attributes.Get(CLOAKING_FUEL)
+		&& energy >= attributes.Get(CLOAKING_ENERGY));
 	if(commands.Has(Command::CLOAK) && canCloak)
 	{
 		cloak = min(1., cloak + cloakingSpeed);
-		fuel -= attributes.Get("cloaking fuel");
-		energy -= attributes.Get("cloaking energy");
+		fuel -= attributes.Get(CLOAKING_FUEL);
+		energy -= attributes.Get(CLOAKING_ENERGY);
 	}
 	else if(cloakingSpeed)
 		cloak = max(0., cloak - cloakingSpeed);
@@ -914,7 +957,7 @@ bool Ship::Move(list<Effect> &effects)
 		--pilotError;
 	else if(pilotOkay)
 		--pilotOkay;
-	else if(requiredCrew && static_cast<int>(Random::Int(requiredCrew)) >= Crew())
+	else if(requiredCrew && static_cast<int>(random.Int(requiredCrew)) >= Crew())
 	{
 		pilotError = 30;
 		Messages::Add("Your ship is moving erratically because you do not have enough crew to pilot it.");
@@ -926,7 +969,7 @@ bool Ship::Move(list<Effect> &effects)
 	// disabled, all it can do is slow down to a stop.
 	double mass = Mass();
 	if(isDisabled)
-		velocity *= 1. - attributes.Get("drag") / mass;
+		velocity *= 1. - attributes.Get(DRAG) / mass;
 	else if(!pilotError)
 	{
 		double thrustCommand = commands.Has(Command::FORWARD) - commands.Has(Command::BACK);
@@ -958,14 +1001,14 @@ bool Ship::Move(list<Effect> &effects)
 		bool applyAfterburner = commands.Has(Command::AFTERBURNER) && !CannotAct();
 		if(applyAfterburner)
 		{
-			double thrust = attributes.Get("afterburner thrust");
-			double cost = attributes.Get("afterburner fuel");
-			double energyCost = attributes.Get("afterburner energy");
+			double thrust = attributes.Get(AFTERBURNER_THRUST);
+			double cost = attributes.Get(AFTERBURNER_FUEL);
+			double energyCost = attributes.Get(AFTERBURNER_ENERGY);
 			if(!thrust || fuel < cost || energy < energyCost)
 				applyAfterburner = false;
 			else
 			{
-				heat += attributes.Get("afterburner heat");
+				heat += attributes.Get(AFTERBURNER_HEAT);
 				fuel -= cost;
 				energy -= energyCost;
 				acceleration += angle.Unit() * thrust / mass;
@@ -985,7 +1028,7 @@ bool Ship::Move(list<Effect> &effects)
 		}
 		if(acceleration)
 		{
-			Point dragAcceleration = acceleration - velocity * (attributes.Get("drag") / mass);
+			Point dragAcceleration = acceleration - velocity * (attributes.Get(DRAG) / mass);
 			// Make sure dragAcceleration has nonzero length, to avoid divide by zero.
 			if(dragAcceleration)
 			{
@@ -998,13 +1041,13 @@ bool Ship::Move(list<Effect> &effects)
 		if(commands.Turn())
 		{
 			// Check if we are able to turn.
-			double cost = attributes.Get("turning energy");
+			double cost = attributes.Get(TURNING_ENERGY);
 			if(energy < cost)
 				commands.SetTurn(0.);
 			else
 			{
 				energy -= cost;
-				heat += attributes.Get("turning heat");
+				heat += attributes.Get(TURNING_HEAT);
 				angle += commands.Turn() * TurnRate();
 			}
 		}
@@ -1050,7 +1093,7 @@ bool Ship::Move(list<Effect> &effects)
 			{
 				isBoarding = false;
 				bool isEnemy = government->IsEnemy(target->government);
-				if(isEnemy && Random::Real() < target->Attributes().Get("self destruct"))
+				if(isEnemy && random.Real() < target->Attributes().Get(SELF_DESTRUCT))
 				{
 					Messages::Add("The " + target->ModelName() + " \"" + target->Name()
 						+ "\" has activated its self-destruct mechanism.");
@@ -1068,18 +1111,18 @@ bool Ship::Move(list<Effect> &effects)
 	{
 		// Hull repair.
 		double oldHull = hull;
-		double hullGeneration = attributes.Get("hull repair rate");
+		double hullGeneration = attributes.Get(HULL_REPAIR_RATE);
 		hull = min(hull + hullGeneration, maxHull);
 		static const double HULL_EXCHANGE_RATE = 1. +
-			(hullGeneration ? attributes.Get("hull energy") / hullGeneration : 0.);
+			(hullGeneration ? attributes.Get(HULL_ENERGY) / hullGeneration : 0.);
 		energy -= HULL_EXCHANGE_RATE * (hull - oldHull);
 		
 		// Recharge shields, but only up to the max. If there is extra shield
 		// energy, use it to recharge fighters and drones.
-		double shieldGeneration = attributes.Get("shield generation");
+		double shieldGeneration = attributes.Get(SHIELD_GENERATION);
 		shields += shieldGeneration;
 		double SHIELD_EXCHANGE_RATE = 1. +
-			(shieldGeneration ? attributes.Get("shield energy") / shieldGeneration : 0.);
+			(shieldGeneration ? attributes.Get(SHIELD_ENERGY) / shieldGeneration : 0.);
 		energy -= SHIELD_EXCHANGE_RATE * shieldGeneration;
 		double excessShields = max(0., shields - maxShields);
 		shields -= excessShields;
@@ -1089,8 +1132,8 @@ bool Ship::Move(list<Effect> &effects)
 			if(!bay.ship)
 				continue;
 			
-			double myGen = bay.ship->Attributes().Get("shield generation");
-			double myMax = bay.ship->Attributes().Get("shields");
+			double myGen = bay.ship->Attributes().Get(SHIELD_GENERATION);
+			double myMax = bay.ship->Attributes().Get(SHIELDS);
 			bay.ship->shields = min(myMax, bay.ship->shields + myGen);
 			if(excessShields > 0. && bay.ship->shields < myMax)
 			{
@@ -1104,8 +1147,8 @@ bool Ship::Move(list<Effect> &effects)
 			if(!bay.ship)
 				continue;
 			
-			double myGen = bay.ship->Attributes().Get("shield generation");
-			double myMax = bay.ship->Attributes().Get("shields");
+			double myGen = bay.ship->Attributes().Get(SHIELD_GENERATION);
+			double myMax = bay.ship->Attributes().Get(SHIELDS);
 			bay.ship->shields = min(myMax, bay.ship->shields + myGen);
 			if(excessShields > 0. && bay.ship->shields < myMax)
 			{
@@ -1145,22 +1188,22 @@ void Ship::Launch(list<shared_ptr<Ship>> &ships)
 		return;
 	
 	for(Bay &bay : fighterBays)
-		if(bay.ship && !Random::Int(60))
+		if(bay.ship && !random.Int(60))
 		{
 			ships.push_back(bay.ship);
 			double maxV = bay.ship->MaxVelocity();
-			Point v = velocity + (.3 * maxV) * angle.Unit() + (.2 * maxV) * Angle::Random().Unit();
+			Point v = velocity + (.3 * maxV) * angle.Unit() + (.2 * maxV) * Angle::Random(random).Unit();
 			bay.ship->Place(position + angle.Rotate(bay.point), v, angle);
 			bay.ship->SetSystem(currentSystem);
 			bay.ship->SetParent(shared_from_this());
 			bay.ship.reset();
 		}
 	for(Bay &bay : droneBays)
-		if(bay.ship && !Random::Int(40))
+		if(bay.ship && !random.Int(40))
 		{
 			ships.push_back(bay.ship);
 			double maxV = bay.ship->MaxVelocity();
-			Point v = velocity + (.3 * maxV) * angle.Unit() + (.2 * maxV) * Angle::Random().Unit();
+			Point v = velocity + (.3 * maxV) * angle.Unit() + (.2 * maxV) * Angle::Random(random).Unit();
 			bay.ship->Place(position + angle.Rotate(bay.point), v, angle);
 			bay.ship->SetSystem(currentSystem);
 			bay.ship->SetParent(shared_from_this());
@@ -1245,9 +1288,9 @@ int Ship::Scan() const
 	
 	int result = 0;
 	double distance = (target->position - position).Length();
-	if(distance < attributes.Get("cargo scan"))
+	if(distance < attributes.Get(CARGO_SCAN))
 		result |= ShipEvent::SCAN_CARGO;
-	if(distance < attributes.Get("outfit scan"))
+	if(distance < attributes.Get(OUTFIT_SCAN))
 		result |= ShipEvent::SCAN_OUTFITS;
 	
 	return result;
@@ -1258,7 +1301,7 @@ int Ship::Scan() const
 // Fire any weapons that are ready to fire. If an anti-missile is ready,
 // instead of firing here this function returns true and it can be fired if
 // collision detection finds a missile in range.
-bool Ship::Fire(list<Projectile> &projectiles, list<Effect> &effects)
+bool Ship::Fire(vector<Projectile> &projectiles, vector<Effect> &effects)
 {
 	isInSystem = true;
 	forget = 0;
@@ -1294,7 +1337,7 @@ bool Ship::Fire(list<Projectile> &projectiles, list<Effect> &effects)
 
 
 // Fire an anti-missile.
-bool Ship::FireAntiMissile(const Projectile &projectile, list<Effect> &effects)
+bool Ship::FireAntiMissile(const Projectile &projectile, vector<Effect> &effects)
 {
 	if(CannotAct())
 		return false;
@@ -1428,10 +1471,10 @@ int Ship::CheckHyperspace() const
 	if(type == 150)
 	{
 		double deviation = fabs(direction.Unit().Cross(velocity));
-		if(deviation > attributes.Get("scram drive"))
+		if(deviation > attributes.Get(SCRAM_DRIVE))
 			return 0;
 	}
-	else if(velocity.Length() > attributes.Get("jump speed"))
+	else if(velocity.Length() > attributes.Get(JUMP_SPEED))
 		return 0;
 	
 	if(type != 200)
@@ -1461,9 +1504,9 @@ int Ship::HyperspaceType() const
 		return 0;
 	
 	// Check what equipment this ship has.
-	bool hasHyperdrive = attributes.Get("hyperdrive");
-	bool hasScramDrive = attributes.Get("scram drive");
-	bool hasJumpDrive = attributes.Get("jump drive");
+	bool hasHyperdrive = attributes.Get(HYPERDRIVE);
+	bool hasScramDrive = attributes.Get(SCRAM_DRIVE);
+	bool hasJumpDrive = attributes.Get(JUMP_DRIVE);
 	
 	// Figure out what sort of jump we're making. 100 = normal hyperspace,
 	// 150 = scram drive, 200 = jump drive.
@@ -1568,16 +1611,16 @@ void Ship::Recharge(bool atSpaceport)
 	if(atSpaceport)
 	{
 		crew = max(crew, RequiredCrew());
-		fuel = attributes.Get("fuel capacity");
+		fuel = attributes.Get(FUEL_CAPACITY);
 	}
 	pilotError = 0;
 	pilotOkay = 0;
 	
 	if(!personality.IsDerelict())
 	{
-		shields = attributes.Get("shields");
-		hull = attributes.Get("hull");
-		energy = attributes.Get("energy capacity");
+		shields = attributes.Get(SHIELDS);
+		hull = attributes.Get(HULL);
+		energy = attributes.Get(ENERGY_CAPACITY);
 	}
 	heat = IdleHeat();
 	ionization = 0.;
@@ -1594,10 +1637,10 @@ bool Ship::CanRefuel(const Ship &other) const
 
 double Ship::TransferFuel(double amount, Ship *to)
 {
-	amount = max(fuel - attributes.Get("fuel capacity"), amount);
+	amount = max(fuel - attributes.Get(FUEL_CAPACITY), amount);
 	if(to)
 	{
-		amount = min(to->attributes.Get("fuel capacity") - to->fuel, amount);
+		amount = min(to->attributes.Get(FUEL_CAPACITY) - to->fuel, amount);
 		to->fuel += amount;
 	}
 	fuel -= amount;
@@ -1644,7 +1687,7 @@ void Ship::WasCaptured(const shared_ptr<Ship> &capturer)
 // Get characteristics of this ship, as a fraction between 0 and 1.
 double Ship::Shields() const
 {
-	double maximum = attributes.Get("shields");
+	double maximum = attributes.Get(SHIELDS);
 	return maximum ? min(1., shields / maximum) : 0.;
 }
 
@@ -1652,7 +1695,7 @@ double Ship::Shields() const
 
 double Ship::Hull() const
 {
-	double maximum = attributes.Get("hull");
+	double maximum = attributes.Get(HULL);
 	return maximum ? min(1., hull / maximum) : 1.;
 }
 
@@ -1660,7 +1703,7 @@ double Ship::Hull() const
 
 double Ship::Energy() const
 {
-	double maximum = attributes.Get("energy capacity");
+	double maximum = attributes.Get(ENERGY_CAPACITY);
 	return maximum ? min(1., energy / maximum) : (hull > 0.) ? 1. : 0.;
 }
 
@@ -1676,7 +1719,7 @@ double Ship::Heat() const
 
 double Ship::Fuel() const
 {
-	double maximum = attributes.Get("fuel capacity");
+	double maximum = attributes.Get(FUEL_CAPACITY);
 	return maximum ? min(1., fuel / maximum) : 0.;
 }
 
@@ -1697,9 +1740,9 @@ double Ship::JumpFuel() const
 	int type = HyperspaceType();
 	if(type)
 		return type;
-	return attributes.Get("jump drive") ? 200. :
-		attributes.Get("scram drive") ? 150. : 
-		attributes.Get("hyperdrive") ? 100. : 0.;
+	return attributes.Get(JUMP_DRIVE) ? 200. :
+		attributes.Get(SCRAM_DRIVE) ? 150. : 
+		attributes.Get(HYPERDRIVE) ? 100. : 0.;
 }
 
 
@@ -1714,8 +1757,8 @@ int Ship::Crew() const
 int Ship::RequiredCrew() const
 {
 	// Drones do not need crew, but all other ships need at least one.
-	return max(attributes.Get("automaton") ? 0 : 1,
-		static_cast<int>(attributes.Get("required crew")));
+	return max(attributes.Get(AUTOMATON) ? 0 : 1,
+		static_cast<int>(attributes.Get(REQUIRED_CREW)));
 }
 
 
@@ -1736,21 +1779,21 @@ double Ship::Mass() const
 	for(const Bay &bay : fighterBays)
 		if(bay.ship)
 			carried += bay.ship->Mass();
-	return carried + cargo.Used() + attributes.Get("mass");
+	return carried + cargo.Used() + attributes.Get(MASS);
 }
 
 
 
 double Ship::TurnRate() const
 {
-	return attributes.Get("turn") / Mass();
+	return attributes.Get(TURN) / Mass();
 }
 
 
 
 double Ship::Acceleration() const
 {
-	return attributes.Get("thrust") / Mass();
+	return attributes.Get(THRUST) / Mass();
 }
 
 
@@ -1760,7 +1803,7 @@ double Ship::MaxVelocity() const
 	// v * drag / mass == thrust / mass
 	// v * drag == thrust
 	// v = thrust / drag
-	return attributes.Get("thrust") / attributes.Get("drag");
+	return attributes.Get(THRUST) / attributes.Get(DRAG);
 }
 
 
@@ -2022,10 +2065,10 @@ void Ship::AddOutfit(const Outfit *outfit, int count)
 		if(outfit->IsWeapon())
 			armament.Add(outfit, count);
 		
-		if(outfit->Get("cargo space"))
-			cargo.SetSize(attributes.Get("cargo space"));
-		if(outfit->Get("hull"))
-			hull += outfit->Get("hull") * count;
+		if(outfit->Get(CARGO_SPACE))
+			cargo.SetSize(attributes.Get(CARGO_SPACE));
+		if(outfit->Get(HULL))
+			hull += outfit->Get(HULL) * count;
 	}
 }
 
@@ -2220,7 +2263,7 @@ double Ship::MinimumHull() const
 	if(neverDisabled)
 		return 0.;
 	
-	double maximumHull = attributes.Get("hull");
+	double maximumHull = attributes.Get(HULL);
 	return max(.20 * maximumHull, min(.50 * maximumHull, 400.));
 }
 
@@ -2229,12 +2272,12 @@ double Ship::MinimumHull() const
 // Get the heat level at idle.
 double Ship::IdleHeat() const
 {
-	return max(0., attributes.Get("heat generation") - attributes.Get("cooling")) / (1. - heatDissipation);
+	return max(0., attributes.Get(HEAT_GENERATION) - attributes.Get(COOLING)) / (1. - heatDissipation);
 }
 
 
 
-void Ship::CreateExplosion(list<Effect> &effects, bool spread)
+void Ship::CreateExplosion(vector<Effect> &effects, bool spread)
 {
 	if(sprite.IsEmpty() || !sprite.GetMask(0).IsLoaded() || explosionEffects.empty())
 		return;
@@ -2242,12 +2285,12 @@ void Ship::CreateExplosion(list<Effect> &effects, bool spread)
 	// Bail out if this loops enough times, just in case.
 	for(int i = 0; i < 10; ++i)
 	{
-		Point point((Random::Real() - .5) * .5 * sprite.Width(),
-			(Random::Real() - .5) * .5 * sprite.Height());
+		Point point((random.Real() - .5) * .5 * sprite.Width(),
+			(random.Real() - .5) * .5 * sprite.Height());
 		if(sprite.GetMask(0).Contains(point, Angle()))
 		{
 			// Pick an explosion.
-			int type = Random::Int(explosionTotal);
+			int type = random.Int(explosionTotal);
 			auto it = explosionEffects.begin();
 			for( ; it != explosionEffects.end(); ++it)
 			{
@@ -2260,7 +2303,7 @@ void Ship::CreateExplosion(list<Effect> &effects, bool spread)
 			if(spread)
 			{
 				double scale = .02 * (sprite.Width() + sprite.Height());
-				effectVelocity += Angle::Random().Unit() * (scale * Random::Real());
+				effectVelocity += Angle::Random(random).Unit() * (scale * random.Real());
 			}
 			effects.back().Place(angle.Rotate(point) + position, effectVelocity, angle);
 			++explosionCount;
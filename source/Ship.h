@@ -21,7 +21,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Outfit.h"
 #include "Personality.h"
 #include "Point.h"
+#include "RandomStream.h"
 
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -104,8 +106,9 @@ public:
 	const Command &Commands() const;
 	// Move this ship. A ship may create effects as it moves, in particular if
 	// it is in the process of blowing up. If this returns false, the ship
-	// should be deleted.
-	bool Move(std::list<Effect> &effects);
+	// should be deleted. Any random numbers the ship needs until it next moves
+	// are drawn from the given stream.
+	bool Move(std::vector<Effect> &effects, const RandomStream &random);
 	// Launch any ships that are ready to launch.
 	void Launch(std::list<std::shared_ptr<Ship>> &ships);
 	// Check if this ship is boarding another ship. If it is, it either plunders
@@ -119,9 +122,9 @@ public:
 	// Fire any weapons that are ready to fire. If an anti-missile is ready,
 	// instead of firing here this function returns true and it can be fired if
 	// collision detection finds a missile in range.
-	bool Fire(std::list<Projectile> &projectiles, std::list<Effect> &effects);
+	bool Fire(std::vector<Projectile> &projectiles, std::vector<Effect> &effects);
 	// Fire an anti-missile. Returns true if the missile was killed.
-	bool FireAntiMissile(const Projectile &projectile, std::list<Effect> &effects);
+	bool FireAntiMissile(const Projectile &projectile, std::vector<Effect> &effects);
 	
 	// Get the system this ship is in.
 	const System *GetSystem() const;
@@ -292,7 +295,7 @@ private:
 	double IdleHeat() const;
 	// Create one of this ship's explosions, within its mask. The explosions can
 	// either stay over the ship, or spread out if this is the final explosion.
-	void CreateExplosion(std::list<Effect> &effects, bool spread = false);
+	void CreateExplosion(std::vector<Effect> &effects, bool spread = false);
 	
 	
 private:
@@ -336,6 +339,8 @@ private:
 	int jettisoned = 0;
 	
 	Command commands;
+	// The stream this ship draws random numbers from during this step.
+	RandomStream random;
 	
 	Personality personality;
 	const Phrase *hail = nullptr;
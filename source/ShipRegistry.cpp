@@ -0,0 +1,68 @@
+/* ShipRegistry.cpp
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "ShipRegistry.h"
+
+#include "Ship.h"
+
+using namespace std;
+
+
+
+// Take a new snapshot of the given ships.
+void ShipRegistry::Update(const list<shared_ptr<Ship>> &all)
+{
+	ships.clear();
+	index.clear();
+	system.clear();
+	position.clear();
+	velocity.clear();
+	government.clear();
+	cost.clear();
+	flags.clear();
+	
+	for(const shared_ptr<Ship> &ship : all)
+	{
+		// Carried fighters and drones are not simulated on their own.
+		if(!ship->GetSystem())
+			continue;
+		
+		index[ship.get()] = ships.size();
+		ships.push_back(ship.get());
+		system.push_back(ship->GetSystem());
+		position.push_back(ship->Position());
+		velocity.push_back(ship->Velocity());
+		government.push_back(ship->GetGovernment());
+		cost.push_back(ship->Cost());
+		flags.push_back(
+			DISABLED * ship->IsDisabled()
+			| TARGETABLE * ship->IsTargetable()
+			| HYPERSPACING * ship->IsHyperspacing());
+	}
+}
+
+
+
+// Get the index of the given ship, or Size() if it is not in the registry.
+unsigned ShipRegistry::Find(const Ship &ship) const
+{
+	auto it = index.find(&ship);
+	return (it == index.end()) ? Size() : it->second;
+}
+
+
+
+// Get the ship with the given index.
+shared_ptr<Ship> ShipRegistry::Shared(unsigned i) const
+{
+	return ships[i]->shared_from_this();
+}
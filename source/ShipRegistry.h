@@ -0,0 +1,137 @@
+/* ShipRegistry.h
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef SHIP_REGISTRY_H_
+#define SHIP_REGISTRY_H_
+
+#include "Point.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Government;
+class Ship;
+class System;
+
+
+
+// Class holding a snapshot of every active ship (that is, every ship that is
+// in a system rather than being carried by another ship), in the same order as
+// the engine's list of ships. The values that the AI checks for every pair of
+// ships each step are copied into densely packed arrays, so searching through
+// the ships does not involve touching each Ship object. The registry does not
+// own the ships; it is only valid until the ships next move or are removed.
+class ShipRegistry {
+public:
+	// Flags describing the state of each ship.
+	static const int DISABLED = 1;
+	static const int TARGETABLE = 2;
+	static const int HYPERSPACING = 4;
+	
+	
+public:
+	// Take a new snapshot of the given ships.
+	void Update(const std::list<std::shared_ptr<Ship>> &ships);
+	
+	unsigned Size() const;
+	// Get the index of the given ship, or Size() if it is not in the registry.
+	unsigned Find(const Ship &ship) const;
+	
+	// Get the ship with the given index.
+	Ship &Get(unsigned i) const;
+	std::shared_ptr<Ship> Shared(unsigned i) const;
+	
+	// Get the state of the ship with the given index, as of the last update.
+	const System *GetSystem(unsigned i) const;
+	const Point &Position(unsigned i) const;
+	const Point &Velocity(unsigned i) const;
+	const Government *GetGovernment(unsigned i) const;
+	int64_t Cost(unsigned i) const;
+	// Check if the ship has any of the given flags set.
+	bool Is(unsigned i, int flag) const;
+	
+	
+private:
+	std::vector<Ship *> ships;
+	std::unordered_map<const Ship *, unsigned> index;
+	
+	std::vector<const System *> system;
+	std::vector<Point> position;
+	std::vector<Point> velocity;
+	std::vector<const Government *> government;
+	std::vector<int64_t> cost;
+	std::vector<uint8_t> flags;
+};
+
+
+
+// Inline accessor functions, for speed:
+inline unsigned ShipRegistry::Size() const
+{
+	return ships.size();
+}
+
+
+
+inline Ship &ShipRegistry::Get(unsigned i) const
+{
+	return *ships[i];
+}
+
+
+
+inline const System *ShipRegistry::GetSystem(unsigned i) const
+{
+	return system[i];
+}
+
+
+
+inline const Point &ShipRegistry::Position(unsigned i) const
+{
+	return position[i];
+}
+
+
+
+inline const Point &ShipRegistry::Velocity(unsigned i) const
+{
+	return velocity[i];
+}
+
+
+
+inline const Government *ShipRegistry::GetGovernment(unsigned i) const
+{
+	return government[i];
+}
+
+
+
+inline int64_t ShipRegistry::Cost(unsigned i) const
+{
+	return cost[i];
+}
+
+
+
+inline bool ShipRegistry::Is(unsigned i, int flag) const
+{
+	return flags[i] & flag;
+}
+
+
+
+#endif
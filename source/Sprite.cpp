@@ -24,14 +24,23 @@ using namespace std;
 
 
 
-Sprite::Sprite()
-	: width(0.f), height(0.f)
+Sprite::Sprite(const string &name)
+	: name(name), width(0.f), height(0.f), used(false)
 {
 }
 
 
 
-void Sprite::AddFrame(int frame, ImageBuffer *image, Mask *mask, bool is2x)
+const string &Sprite::Name() const
+{
+	return name;
+}
+
+
+
+// Add a frame, uploading its texture unless this is running without any
+// graphics (in which case only its size and collision mask are kept).
+void Sprite::AddFrame(int frame, ImageBuffer *image, Mask *mask, bool is2x, bool uploadTexture)
 {
 	if(!image || frame < 0)
 		return;
@@ -39,9 +48,35 @@ void Sprite::AddFrame(int frame, ImageBuffer *image, Mask *mask, bool is2x)
 	width = max(width, static_cast<float>(image->Width() / (1 + is2x)));
 	height = max(height, static_cast<float>(image->Height() / (1 + is2x)));
 	
+	// Even without a texture, the frame must be counted.
 	vector<uint32_t> &textureIndex = (is2x ? textures2x : textures);
 	if(textureIndex.size() <= static_cast<unsigned>(frame))
 		textureIndex.resize(frame + 1, 0);
+	if(uploadTexture)
+		Upload(frame, image, is2x);
+	delete image;
+	
+	if(mask)
+	{
+		if(masks.size() <= static_cast<unsigned>(frame))
+			masks.resize(frame + 1);
+		masks[frame] = move(*mask);
+		delete mask;
+	}
+}
+
+
+
+// Upload the texture for a frame that has already been added, or replace
+// it with a single transparent pixel if the image is null. The texture's
+// ID does not change, so anything that already has a copy of it can still
+// safely draw it.
+void Sprite::Upload(int frame, const ImageBuffer *image, bool is2x)
+{
+	vector<uint32_t> &textureIndex = (is2x ? textures2x : textures);
+	if(frame < 0 || static_cast<unsigned>(frame) >= textureIndex.size())
+		return;
+	
 	if(!textureIndex[frame])
 		glGenTextures(1, &textureIndex[frame]);
 	glBindTexture(GL_TEXTURE_2D, textureIndex[frame]);
@@ -53,19 +88,27 @@ void Sprite::AddFrame(int frame, ImageBuffer *image, Mask *mask, bool is2x)
 	
 	// ImageBuffer always loads images into 32-bit BGRA buffers.
 	// That is supposedly the fastest format to upload.
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image->Width(), image->Height(), 0,
-		GL_BGRA, GL_UNSIGNED_BYTE, image->Pixels());
+	static const uint32_t transparent = 0;
+	if(image)
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image->Width(), image->Height(), 0,
+			GL_BGRA, GL_UNSIGNED_BYTE, image->Pixels());
+	else
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0,
+			GL_BGRA, GL_UNSIGNED_BYTE, &transparent);
 	
 	glBindTexture(GL_TEXTURE_2D, 0);
-	delete image;
-	
-	if(mask)
-	{
-		if(masks.size() <= static_cast<unsigned>(frame))
-			masks.resize(frame + 1);
-		masks[frame] = move(*mask);
-		delete mask;
-	}
+}
+
+
+
+// Free up the memory of all this sprite's textures, but keep its size and
+// collision masks, and keep its textures' IDs valid.
+void Sprite::UnloadTextures()
+{
+	for(unsigned i = 0; i < textures.size(); ++i)
+		Upload(i, nullptr, false);
+	for(unsigned i = 0; i < textures2x.size(); ++i)
+		Upload(i, nullptr, true);
 }
 
 
@@ -121,6 +164,7 @@ Point Sprite::Center() const
 
 uint32_t Sprite::Texture(int frame) const
 {
+	used.store(true, memory_order_relaxed);
 	if(Screen::IsHighResolution() && !textures2x.empty())
 		return textures2x[frame % textures2x.size()];
 	
@@ -140,3 +184,12 @@ const Mask &Sprite::GetMask(int frame) const
 	
 	return masks[frame % masks.size()];
 }
+
+
+
+// Check if this sprite's textures have been asked for since the last time
+// this function was called.
+bool Sprite::WasUsed() const
+{
+	return used.exchange(false, memory_order_relaxed);
+}
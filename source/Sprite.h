@@ -16,7 +16,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Mask.h"
 #include "Point.h"
 
+#include <atomic>
 #include <cstdint>
+#include <string>
 #include <vector>
 
 class ImageBuffer;
@@ -31,12 +33,28 @@ class ImageBuffer;
 // working with the graphics a lot simpler.
 class Sprite {
 public:
-	Sprite();
+	explicit Sprite(const std::string &name = "");
 	
-	void AddFrame(int frame, ImageBuffer *image, Mask *mask, bool is2x);
+	const std::string &Name() const;
+	
+	// Add a frame, uploading its texture unless this is running without any
+	// graphics (in which case only its size and collision mask are kept).
+	void AddFrame(int frame, ImageBuffer *image, Mask *mask, bool is2x, bool uploadTexture = true);
+	// Upload the texture for a frame that has already been added, or replace
+	// it with a single transparent pixel if the image is null. The texture's
+	// ID does not change, so anything that already has a copy of it can still
+	// safely draw it.
+	void Upload(int frame, const ImageBuffer *image, bool is2x);
+	// Free up the memory of all this sprite's textures, but keep its size and
+	// collision masks, and keep its textures' IDs valid.
+	void UnloadTextures();
 	// Free up all textures loaded for this sprite.
 	void Unload();
 	
+	// Check if this sprite's textures have been asked for since the last time
+	// this function was called.
+	bool WasUsed() const;
+	
 	float Width() const;
 	float Height() const;
 	int Frames() const;
@@ -50,12 +68,17 @@ public:
 	
 	
 private:
+	std::string name;
+	
 	std::vector<uint32_t> textures;
 	std::vector<uint32_t> textures2x;
 	std::vector<Mask> masks;
 	
 	float width;
 	float height;
+	
+	// This is set by Texture(), which may be called from any thread.
+	mutable std::atomic<bool> used;
 };
 
 
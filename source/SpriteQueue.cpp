@@ -17,11 +17,36 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Sprite.h"
 #include "SpriteSet.h"
 
+#include <algorithm>
 #include <functional>
+#include <iomanip>
+#include <sstream>
 
 using namespace std;
 
 namespace {
+	// Only the textures of these kinds of sprites are streamed. Anything else
+	// (effects, projectiles, the user interface) may show up at any moment, and
+	// takes up little memory anyway, so it is always kept loaded.
+	const string STREAMED[] = {"land/", "outfit/", "planet/", "scene/", "ship/", "star/"};
+	
+	// By default, allow the streamed textures to take up this much memory.
+	const size_t DEFAULT_BUDGET = 256 << 20;
+	
+	// Decoding images is the slowest part of loading, so use every core. Use
+	// at least this many threads, because they also spend time waiting for
+	// the disk.
+	const unsigned MIN_THREADS = 4;
+	
+	bool IsStreamed(const string &name)
+	{
+		for(const string &prefix : STREAMED)
+			if(!name.compare(0, prefix.length(), prefix))
+				return true;
+		return false;
+	}
+	
+	
 	// Check if the given image is an @2x image.
 	bool Is2x(const string &path)
 	{
@@ -33,7 +58,7 @@ namespace {
 
 
 SpriteQueue::SpriteQueue()
-	: added(0), completed(0), threads(4)
+	: added(0), completed(0), budget(DEFAULT_BUDGET), threads(max(MIN_THREADS, thread::hardware_concurrency()))
 {
 	for(thread &t : threads)
 		t = thread(ref(*this));
@@ -66,7 +91,17 @@ void SpriteQueue::Add(const string &name, const string &path)
 		
 		bool is2x = Is2x(path);
 		int &frame = (is2x ? count2x[name] : count[name]);
-		toRead.emplace(sprite, name, path, frame++, is2x);
+		toRead.emplace(sprite, name, path, frame, is2x);
+		
+		// Without any graphics, there are no textures to stream.
+		if(!skipTextures && IsStreamed(name))
+		{
+			toRead.back().isStreamed = true;
+			Stream &stream = streams[sprite];
+			stream.sprite = sprite;
+			stream.images.emplace_back(path, frame, is2x);
+		}
+		++frame;
 		++added;
 	}
 	readCondition.notify_one();
@@ -74,17 +109,145 @@ void SpriteQueue::Add(const string &name, const string &path)
 
 
 
-// Unload the texture for the given sprite (to free up memory).
-void SpriteQueue::Unload(const string &name)
+// Add a sprite that should not be read from disk at all until it is needed.
+// Until then, it does not even have a size.
+void SpriteQueue::Defer(const string &name, const string &path)
+{
+	Sprite *sprite = SpriteSet::Modify(name);
+	Stream &stream = streams[sprite];
+	stream.sprite = sprite;
+	stream.isDeferred = true;
+	
+	bool is2x = Is2x(path);
+	int &frame = (is2x ? count2x[name] : count[name]);
+	stream.images.emplace_back(path, frame++, is2x);
+}
+
+
+
+// Begin loading the given streamed sprite, because it will probably be
+// drawn soon. This may be called from any thread.
+void SpriteQueue::Preload(const Sprite *sprite)
+{
+	// This may be called from the engine's calculation thread, so it must not
+	// touch the streams. Instead, the next Update() will request this sprite.
+	lock_guard<mutex> lock(preloadMutex);
+	preloads.push_back(sprite);
+}
+
+
+
+// Set the most memory that the streamed textures may use, in bytes. Zero
+// means there is no limit.
+void SpriteQueue::SetBudget(size_t bytes)
+{
+	budget = bytes;
+}
+
+
+
+// Upload any textures that have finished loading, begin loading any streamed
+// sprites that were just drawn without being loaded, and unload the least
+// recently used ones if they are over budget. Call this once per frame.
+void SpriteQueue::Update()
 {
 	{
-		lock_guard<mutex> lock(readMutex);
-		count2x[name] = 0;
-		count[name] = 0;
+		unique_lock<mutex> lock(loadMutex);
+		DoLoad(lock);
 	}
 	
+	++updates;
+	
+	// Begin loading any sprites that will probably be drawn soon. Treat them
+	// as if they were just used, so that they will not be unloaded again
+	// before they have a chance to be drawn.
+	vector<const Sprite *> requested;
+	{
+		lock_guard<mutex> lock(preloadMutex);
+		requested.swap(preloads);
+	}
+	for(const Sprite *sprite : requested)
+	{
+		auto it = streams.find(sprite);
+		if(it == streams.end())
+			continue;
+		
+		it->second.lastUse = updates;
+		Request(it->second);
+	}
+	
+	for(auto &it : streams)
+	{
+		Stream &stream = it.second;
+		if(!stream.sprite->WasUsed())
+			continue;
+		
+		stream.lastUse = updates;
+		if(stream.isResident)
+			++hits;
+		else if(stream.pending)
+			++stalls;
+		else
+		{
+			++misses;
+			Request(stream);
+		}
+	}
+	
+	// Never unload anything that was used in this frame, even if that means
+	// going over the budget.
+	while(budget && residentBytes > budget)
+	{
+		Stream *oldest = nullptr;
+		for(auto &it : streams)
+		{
+			Stream &stream = it.second;
+			if(stream.isResident && stream.lastUse != updates && (!oldest || stream.lastUse < oldest->lastUse))
+				oldest = &stream;
+		}
+		if(!oldest)
+			break;
+		
+		if(oldest->isDeferred)
+			oldest->sprite->Unload();
+		else
+			oldest->sprite->UnloadTextures();
+		oldest->isResident = false;
+		residentBytes -= oldest->bytes;
+		++evictions;
+	}
+}
+
+
+
+// Get a summary of how often streamed sprites were loaded when needed.
+string SpriteQueue::Statistics() const
+{
+	ostringstream out;
+	out << "Streamed sprites: " << hits << " hits, " << misses << " misses, "
+		<< stalls << " stalls, " << evictions << " evictions; "
+		<< (residentBytes >> 20) << " MB of textures loaded";
+	if(budget)
+		out << " (budget: " << (budget >> 20) << " MB)";
+	out << ".";
+	return out.str();
+}
+
+
+
+// Get a summary of how quickly the images were read and decoded.
+string SpriteQueue::Throughput() const
+{
 	unique_lock<mutex> lock(loadMutex);
-	toUnload.push(name);
+	double seconds = chrono::duration<double>(lastRead - firstRead).count();
+	ostringstream out;
+	out << "Read " << imagesRead << " images (" << (bytesRead >> 20) << " MB) in "
+		<< fixed << setprecision(3) << seconds << " seconds with " << threads.size() << " threads";
+	if(seconds > 0.)
+		out << setprecision(1) << ": " << (bytesRead / seconds) / (1 << 20) << " MB/s, "
+			<< imagesRead / seconds << " images/s";
+	out << ".";
+	return out.str();
 }
 
 
@@ -118,6 +281,15 @@ void SpriteQueue::Finish() const
 
 
 
+// Only load the sprites' sizes and collision masks, not their textures.
+// This must be set before any sprites are added.
+void SpriteQueue::SkipTextures()
+{
+	skipTextures = true;
+}
+
+
+
 // Thread entry point.
 void SpriteQueue::operator()()
 {
@@ -138,17 +310,14 @@ void SpriteQueue::operator()()
 			
 			lock.unlock();
 			
-			// Load the sprite.
-			item.image = ImageBuffer::Read(item.path);
-			// If sprite loading fails, just skip this sprite.
-			if(!item.image)
-			{
-				lock.lock();
-				continue;
-			}
+			// Load the sprite. If that fails, the item must still be passed on,
+			// so that the sprite will not be counted as still loading forever.
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			size_t bytes = 0;
+			item.image = ImageBuffer::Read(item.path, &bytes);
 			// Don't ever create masks for @2x sprites; just use the ordinary
-			// sprite masks instead.
-			if(!item.is2x && (!item.name.compare(0, 5, "ship/") || !item.name.compare(0, 9, "asteroid/")))
+			// sprite masks instead. Reloading a texture does not change its mask.
+			if(item.image && !item.is2x && !item.isReload && (!item.name.compare(0, 5, "ship/") || !item.name.compare(0, 9, "asteroid/")))
 			{
 				item.mask = new Mask;
 				item.mask->Create(item.image);
@@ -161,6 +330,17 @@ void SpriteQueue::operator()()
 				// The texture must be uploaded to OpenGL in the main thread.
 				unique_lock<mutex> lock(loadMutex);
 				toLoad.push(item);
+				
+				// Keep track of how quickly the sprites are read when the game
+				// first loads, not counting streamed sprites being reloaded.
+				if(!item.isReload)
+				{
+					if(!imagesRead || start < firstRead)
+						firstRead = start;
+					lastRead = max(lastRead, chrono::steady_clock::now());
+					bytesRead += bytes;
+					++imagesRead;
+				}
 			}
 			loadCondition.notify_one();
 			
@@ -172,18 +352,34 @@ void SpriteQueue::operator()()
 }
 
 
-double SpriteQueue::DoLoad(unique_lock<mutex> &lock) const
+// Queue up all of a streamed sprite's images to be loaded, if they are not
+// already loaded or being loaded.
+void SpriteQueue::Request(Stream &stream)
 {
-	while(!toUnload.empty())
+	if(stream.isResident || stream.pending)
+		return;
+	
+	stream.bytes = 0;
+	stream.pending = stream.images.size();
 	{
-		Sprite *sprite = SpriteSet::Modify(toUnload.front());
-		toUnload.pop();
+		lock_guard<mutex> lock(readMutex);
+		if(added < 0)
+			return;
 		
-		lock.unlock();
-		sprite->Unload();
-		lock.lock();
+		for(const auto &image : stream.images)
+		{
+			toRead.emplace(stream.sprite, "", get<0>(image), get<1>(image), get<2>(image));
+			toRead.back().isReload = true;
+			++added;
+		}
 	}
-	
+	readCondition.notify_all();
+}
+
+
+
+double SpriteQueue::DoLoad(unique_lock<mutex> &lock) const
+{
 	for(int i = 0; !toLoad.empty() && i < 30; ++i)
 	{
 		Item item = toLoad.front();
@@ -191,7 +387,35 @@ double SpriteQueue::DoLoad(unique_lock<mutex> &lock) const
 		
 		lock.unlock();
 		
-		item.sprite->AddFrame(item.frame, item.image, item.mask, item.is2x);
+		size_t bytes = item.image ? 4 * static_cast<size_t>(item.image->Width()) * item.image->Height() : 0;
+		if(!item.isReload)
+		{
+			// The first time a streamed sprite is read, only its size and mask
+			// are kept, and its texture is just a transparent placeholder.
+			item.sprite->AddFrame(item.frame, item.image, item.mask, item.is2x, !skipTextures && !item.isStreamed);
+			if(item.isStreamed)
+			{
+				item.sprite->Upload(item.frame, nullptr, item.is2x);
+				streams[item.sprite].bytes += bytes;
+			}
+		}
+		else
+		{
+			Stream &stream = streams[item.sprite];
+			if(stream.isDeferred)
+				item.sprite->AddFrame(item.frame, item.image, item.mask, item.is2x);
+			else
+			{
+				item.sprite->Upload(item.frame, item.image, item.is2x);
+				delete item.image;
+			}
+			stream.bytes += bytes;
+			if(!--stream.pending)
+			{
+				stream.isResident = true;
+				residentBytes += stream.bytes;
+			}
+		}
 		
 		lock.lock();
 		++completed;
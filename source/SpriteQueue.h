@@ -13,12 +13,15 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef SPRITE_QUEUE_H_
 #define SPRITE_QUEUE_H_
 
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <map>
 #include <mutex>
 #include <queue>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 class ImageBuffer;
@@ -29,6 +32,12 @@ class Sprite;
 
 // Class for queuing up a list of sprites to be loaded from the disk, with a set of
 // worker threads that begins loading them as soon as they are added.
+//
+// The textures of some sprites (ships, planets, landscapes, etc.) are "streamed":
+// they are only uploaded to OpenGL once the sprite is drawn or is expected to be
+// needed soon, and the least recently used ones are unloaded again whenever the
+// streamed textures take up more memory than the budget allows. Until a streamed
+// texture is loaded, it is just a transparent pixel, so nothing is drawn.
 class SpriteQueue {
 public:
 	SpriteQueue();
@@ -36,19 +45,45 @@ public:
 	
 	// Add a sprite to load.
 	void Add(const std::string &name, const std::string &path);
-	// Unload the texture for the given sprite (to free up memory).
-	void Unload(const std::string &name);
+	// Add a sprite that should not be read from disk at all until it is needed.
+	// Until then, it does not even have a size.
+	void Defer(const std::string &name, const std::string &path);
+	// Begin loading the given streamed sprite, because it will probably be
+	// drawn soon. This may be called from any thread.
+	void Preload(const Sprite *sprite);
+	// Set the most memory that the streamed textures may use, in bytes. Zero
+	// means there is no limit.
+	void SetBudget(size_t bytes);
+	// Upload any textures that have finished loading, begin loading any streamed
+	// sprites that were just drawn without being loaded, and unload the least
+	// recently used ones if they are over budget. Call this once per frame.
+	void Update();
+	// Get a summary of how often streamed sprites were loaded when needed.
+	std::string Statistics() const;
+	// Get a summary of how quickly the images were read and decoded.
+	std::string Throughput() const;
+	
 	// Find out our percent completion.
 	double Progress() const;
 	// Finish loading.
 	void Finish() const;
+	// Only load the sprites' sizes and collision masks, not their textures.
+	// This must be set before any sprites are added.
+	void SkipTextures();
 	
 	// Thread entry point.
 	void operator()();
 	
 	
+private:
+	class Stream;
+	
+	
 private:
 	double DoLoad(std::unique_lock<std::mutex> &lock) const;
+	// Queue up all of a streamed sprite's images to be loaded, if they are not
+	// already loaded or being loaded.
+	void Request(Stream &stream);
 	
 	
 private:
@@ -63,6 +98,28 @@ private:
 		Mask *mask;
 		int frame;
 		bool is2x;
+		// A streamed sprite is first read just to find its size and mask. When it
+		// is actually needed, it is read again to "reload" its texture.
+		bool isStreamed = false;
+		bool isReload = false;
+	};
+	
+	// The state of one streamed sprite. These are only ever used in the main
+	// thread, so they do not need to be protected by a mutex. Other threads
+	// ask for sprites to be preloaded through a separate, locked list.
+	class Stream {
+	public:
+		Sprite *sprite = nullptr;
+		// The path, frame number, and @2x flag of each of the sprite's images.
+		std::vector<std::tuple<std::string, int, bool>> images;
+		// How much memory the textures take up when they are loaded.
+		size_t bytes = 0;
+		// How many of the images are still waiting to be uploaded.
+		int pending = 0;
+		// The last time (in calls to Update()) that this sprite was used.
+		unsigned lastUse = 0;
+		bool isDeferred = false;
+		bool isResident = false;
 	};
 	
 	
@@ -80,8 +137,31 @@ private:
 	mutable std::mutex loadMutex;
 	mutable std::condition_variable loadCondition;
 	mutable int completed;
+	// How many images have been read from disk, and the time from when the
+	// first one began to be read until the last one was finished. These are
+	// protected by loadMutex.
+	size_t bytesRead = 0;
+	unsigned imagesRead = 0;
+	std::chrono::steady_clock::time_point firstRead;
+	std::chrono::steady_clock::time_point lastRead;
+	
+	bool skipTextures = false;
 	
-	mutable std::queue<std::string> toUnload;
+	mutable std::map<const Sprite *, Stream> streams;
+	// Sprites that Preload() was asked to load, which the next Update() will
+	// request. Preload() may be called from any thread.
+	std::vector<const Sprite *> preloads;
+	std::mutex preloadMutex;
+	mutable size_t residentBytes = 0;
+	size_t budget;
+	unsigned updates = 0;
+	// Statistics: each time a streamed sprite is used, it either was already
+	// loaded (a hit), was not (a miss), or was still being loaded (a stall).
+	// Evictions are the number of times a sprite was unloaded to save memory.
+	unsigned hits = 0;
+	unsigned misses = 0;
+	unsigned stalls = 0;
+	unsigned evictions = 0;
 	
 	std::vector<std::thread> threads;
 };
@@ -15,6 +15,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Sprite.h"
 
 #include <map>
+#include <tuple>
+#include <utility>
 
 using namespace std;
 
@@ -26,12 +28,15 @@ namespace {
 
 const Sprite *SpriteSet::Get(const string &name)
 {
-	return &sprites[name];
+	return Modify(name);
 }
 
 
 
 Sprite *SpriteSet::Modify(const string &name)
 {
-	return &sprites[name];
+	auto it = sprites.find(name);
+	if(it == sprites.end())
+		it = sprites.emplace(piecewise_construct, forward_as_tuple(name), forward_as_tuple(name)).first;
+	return &it->second;
 }
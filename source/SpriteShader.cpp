@@ -22,15 +22,22 @@ using namespace std;
 namespace {
 	Shader shader;
 	GLint scaleI;
-	GLint transformI;
-	GLint positionI;
-	GLint blurI;
-	GLint clipI;
-	GLint fadeI;
+	// Everything except the scale is a vertex attribute, so that it can either
+	// be set once for a single sprite or given separately for each instance.
+	GLint transformA;
+	GLint positionA;
+	GLint blurA;
+	GLint clipA;
+	GLint fadeA;
 	
 	GLuint vao;
 	GLuint vbo;
-
+	// This vertex array also has an array of per-instance data, for drawing
+	// many copies of the same sprite in a single call.
+	GLuint instanceVao;
+	GLuint instanceVbo;
+	bool canInstance = false;
+	
 	static const GLint SWIZZLE[9][4] = {
 		{GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}, // red + yellow markings (republic)
 		{GL_RED, GL_BLUE, GL_GREEN, GL_ALPHA}, // red + magenta markings
@@ -42,6 +49,23 @@ namespace {
 		{GL_BLUE, GL_ZERO, GL_ZERO, GL_ALPHA},  // red only (cloaked)
 		{GL_ZERO, GL_ZERO, GL_ZERO, GL_ALPHA}  // black only (outline)
 	};
+	
+	// Bind the given textures (if tex1 is nonzero, it is the one being faded
+	// to) and set their color swizzle.
+	void BindTextures(uint32_t tex0, uint32_t tex1, int swizzle)
+	{
+		glBindTexture(GL_TEXTURE_2D, tex0);
+		if(tex1)
+		{
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, tex1);
+			glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, SWIZZLE[swizzle]);
+			glActiveTexture(GL_TEXTURE0);
+		}
+		
+		// Set the color swizzle.
+		glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, SWIZZLE[swizzle]);
+	}
 }
 
 
@@ -50,37 +74,42 @@ namespace {
 void SpriteShader::Init()
 {
 	static const char *vertexCode =
-		"uniform mat2 transform;\n"
-		"uniform vec2 position;\n"
 		"uniform vec2 scale;\n"
-		"uniform vec2 blur;\n"
-		"uniform float clip;\n"
 		
 		"in vec2 vert;\n"
+		"in vec2 position;\n"
+		"in vec4 transform;\n"
+		"in vec2 blur;\n"
+		"in float clip;\n"
+		"in float fade;\n"
 		"out vec2 fragTexCoord;\n"
+		"flat out vec2 fragBlur;\n"
+		"flat out float fragFade;\n"
 		
 		"void main() {\n"
 		"  vec2 blurOff = 2 * vec2(vert.x * abs(blur.x), vert.y * abs(blur.y));\n"
-		"  gl_Position = vec4((transform * (vert + blurOff) + position) * scale, 0, 1);\n"
+		"  gl_Position = vec4((mat2(transform) * (vert + blurOff) + position) * scale, 0, 1);\n"
 		"  vec2 texCoord = vert + vec2(.5, .5);\n"
-		"  fragTexCoord = vec2(texCoord.x, max(clip, texCoord.y)) + blurOff;\n"
+		"  fragTexCoord = vec2(texCoord.x, max(1 - clip, texCoord.y)) + blurOff;\n"
+		"  fragBlur = blur;\n"
+		"  fragFade = fade;\n"
 		"}\n";
 
 	static const char *fragmentCode =
 		"uniform sampler2D tex0;\n"
 		"uniform sampler2D tex1;\n"
-		"uniform float fade;\n"
-		"uniform vec2 blur;\n"
 		"const int range = 5;\n"
 		
 		"in vec2 fragTexCoord;\n"
+		"flat in vec2 fragBlur;\n"
+		"flat in float fragFade;\n"
 		"out vec4 finalColor;\n"
 		
 		"void main() {\n"
-		"  if(blur.x == 0 && blur.y == 0)\n"
+		"  if(fragBlur.x == 0 && fragBlur.y == 0)\n"
 		"  {\n"
-		"    if(fade != 0)\n"
-		"     finalColor = mix(texture(tex0, fragTexCoord), texture(tex1, fragTexCoord), fade);\n"
+		"    if(fragFade != 0)\n"
+		"     finalColor = mix(texture(tex0, fragTexCoord), texture(tex1, fragTexCoord), fragFade);\n"
 		"    else\n"
 		"      finalColor = texture(tex0, fragTexCoord);\n"
 		"    return;\n"
@@ -90,9 +119,9 @@ void SpriteShader::Init()
 		"  for(int i = -range; i <= range; ++i)\n"
 		"  {\n"
 		"    float scale = (range + 1 - abs(i)) / divisor;\n"
-		"    vec2 coord = fragTexCoord + (blur * i) / range;\n"
-		"    if(fade != 0)\n"
-		"      color += scale * mix(texture(tex0, coord), texture(tex1, coord), fade);\n"
+		"    vec2 coord = fragTexCoord + (fragBlur * i) / range;\n"
+		"    if(fragFade != 0)\n"
+		"      color += scale * mix(texture(tex0, coord), texture(tex1, coord), fragFade);\n"
 		"    else\n"
 		"      color += scale * texture(tex0, coord);\n"
 		"  }\n"
@@ -101,11 +130,11 @@ void SpriteShader::Init()
 	
 	shader = Shader(vertexCode, fragmentCode);
 	scaleI = shader.Uniform("scale");
-	transformI = shader.Uniform("transform");
-	positionI = shader.Uniform("position");
-	blurI = shader.Uniform("blur");
-	clipI = shader.Uniform("clip");
-	fadeI = shader.Uniform("fade");
+	transformA = shader.Attrib("transform");
+	positionA = shader.Attrib("position");
+	blurA = shader.Attrib("blur");
+	clipA = shader.Attrib("clip");
+	fadeA = shader.Attrib("fade");
 	
 	glUseProgram(shader.Object());
 	glUniform1i(shader.Uniform("tex0"), 0);
@@ -134,6 +163,44 @@ void SpriteShader::Init()
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
+	
+	// Instanced drawing needs glVertexAttribDivisor(), which is only part of
+	// the core profile starting in OpenGL 3.3.
+#ifdef __APPLE__
+	canInstance = true;
+#else
+	canInstance = GLEW_VERSION_3_3;
+#endif
+	if(!canInstance)
+		return;
+	
+	glGenVertexArrays(1, &instanceVao);
+	glBindVertexArray(instanceVao);
+	
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glEnableVertexAttribArray(shader.Attrib("vert"));
+	glVertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE,
+		2 * sizeof(GLfloat), NULL);
+	
+	glGenBuffers(1, &instanceVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	
+	// The layout of each instance is described in SpriteShader.h.
+	const GLint attributes[5] = {positionA, transformA, blurA, clipA, fadeA};
+	const GLint sizes[5] = {2, 4, 2, 1, 1};
+	const GLsizei stride = INSTANCE_SIZE * sizeof(GLfloat);
+	size_t offset = 0;
+	for(int i = 0; i < 5; ++i)
+	{
+		glEnableVertexAttribArray(attributes[i]);
+		glVertexAttribPointer(attributes[i], sizes[i], GL_FLOAT, GL_FALSE,
+			stride, reinterpret_cast<const GLvoid *>(offset * sizeof(GLfloat)));
+		glVertexAttribDivisor(attributes[i], 1);
+		offset += sizes[i];
+	}
+	
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
 }
 
 
@@ -168,30 +235,47 @@ void SpriteShader::Bind()
 
 void SpriteShader::Add(uint32_t tex0, uint32_t tex1, const float position[2], const float transform[4], int swizzle, float clip, float fade, const float blur[2])
 {
-	glUniformMatrix2fv(transformI, 1, false, transform);
-	glUniform2fv(positionI, 1, position);
-	glBindTexture(GL_TEXTURE_2D, tex0);
+	if(!(fade && tex1))
+		fade = 0.f;
+	BindTextures(tex0, fade ? tex1 : 0, swizzle);
+	
+	// With no attribute arrays enabled, these values apply to every vertex.
+	glVertexAttrib4fv(transformA, transform);
+	glVertexAttrib2fv(positionA, position);
+	glVertexAttrib1f(clipA, clip);
+	glVertexAttrib1f(fadeA, fade);
+	const float noBlur[2] = {0.f, 0.f};
+	glVertexAttrib2fv(blurA, blur ? blur : noBlur);
+	
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+
+
+// Draw a batch of sprites that all use the same textures and color swizzle.
+// If tex1 is zero, every sprite's fade value must also be zero.
+void SpriteShader::AddBatch(uint32_t tex0, uint32_t tex1, int swizzle, const float *instances, int count)
+{
+	if(count <= 0)
+		return;
 	
-	if(fade && tex1)
+	// Without instancing, fall back to drawing the sprites one at a time.
+	if(!canInstance)
 	{
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, tex1);
-		glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, SWIZZLE[swizzle]);
-		glActiveTexture(GL_TEXTURE0);
+		for(const float *it = instances; it != instances + count * INSTANCE_SIZE; it += INSTANCE_SIZE)
+			Add(tex0, tex1, it, it + 2, swizzle, it[8], it[9], it + 6);
+		return;
 	}
-	else
-		fade = 0.f;
 	
-	// Set the color swizzle.
-	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, SWIZZLE[swizzle]);
+	BindTextures(tex0, tex1, swizzle);
 	
-	// Set the clipping.
-	glUniform1f(clipI, 1.f - clip);
-	glUniform1f(fadeI, fade);
-	const float noBlur[2] = {0.f, 0.f};
-	glUniform2fv(blurI, 1, blur ? blur : noBlur);
+	glBindVertexArray(instanceVao);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, count * INSTANCE_SIZE * sizeof(GLfloat), instances, GL_STREAM_DRAW);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
 	
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(vao);
 }
 
 
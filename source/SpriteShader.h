@@ -35,7 +35,14 @@ public:
 	
 	static void Bind();
 	static void Add(uint32_t tex0, uint32_t tex1, const float position[2], const float transform[4], int swizzle = 0, float clip = 1., float fade = 0., const float blur[2] = nullptr);
+	// Draw a batch of sprites that all use the same textures and color swizzle.
+	// If tex1 is zero, every sprite's fade value must also be zero.
+	static void AddBatch(uint32_t tex0, uint32_t tex1, int swizzle, const float *instances, int count);
 	static void Unbind();
+	
+	// In a batch, each sprite is given by this many floats: its position (2),
+	// transform matrix (4), blur vector (2), clip, and fade, in that order.
+	static const int INSTANCE_SIZE = 10;
 };
 
 
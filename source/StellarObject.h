@@ -16,6 +16,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Animation.h"
 #include "Point.h"
 
+#include <string>
+
 class Planet;
 
 
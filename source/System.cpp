@@ -22,6 +22,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Random.h"
 
 #include <cmath>
+#include <map>
 
 using namespace std;
 
@@ -34,6 +35,21 @@ namespace {
 	static const double VOLUME = 2000.;
 	// Above this supply amount, price differences taper off:
 	static const double LIMIT = 20000.;
+	
+	// The index of each commodity name that has been used. Iterating over this
+	// visits the commodities in order of their names.
+	map<string, int> &CommodityIndices()
+	{
+		static map<string, int> indices;
+		return indices;
+	}
+	
+	// Find the index of the given commodity, or -1 if it has never been used.
+	int FindCommodity(const string &commodity)
+	{
+		auto it = CommodityIndices().find(commodity);
+		return (it == CommodityIndices().end()) ? -1 : it->second;
+	}
 }
 
 const double System::NEIGHBOR_DISTANCE = 100.;
@@ -133,7 +149,7 @@ void System::Load(const DataNode &node, Set<Planet> &planets)
 				asteroids.emplace_back(child.Token(1), child.Value(2), child.Value(3));
 		}
 		else if(child.Token(0) == "trade" && child.Size() >= 3)
-			trade[child.Token(1)].SetBase(child.Value(2));
+			GetPrice(CommodityIndex(child.Token(1))).SetBase(child.Value(2));
 		else if(child.Token(0) == "fleet")
 		{
 			if(resetFleets)
@@ -403,11 +419,22 @@ const vector<System::Asteroid> &System::Asteroids() const
 
 
 
+// Get the index of the given commodity. Each commodity name is given an
+// index the first time it is used, so the trade information for each
+// system can be stored in a vector instead of being looked up by name.
+int System::CommodityIndex(const string &commodity)
+{
+	map<string, int> &indices = CommodityIndices();
+	return indices.emplace(commodity, indices.size()).first->second;
+}
+
+
+
 // Get the price of the given commodity in this system.
 int System::Trade(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.price;
+	const Price *it = FindPrice(FindCommodity(commodity));
+	return it ? it->price : 0;
 }
 
 
@@ -415,12 +442,18 @@ int System::Trade(const string &commodity) const
 // Update the economy.
 void System::StepEconomy()
 {
-	for(auto &it : trade)
+	// The random production amounts must be chosen in order of the commodity
+	// names, so that the same random seed always gives the same economy.
+	for(const auto &cit : CommodityIndices())
 	{
-		it.second.exports = EXPORT * it.second.supply;
-		it.second.supply *= KEEP;
-		it.second.supply += Random::Normal() * VOLUME;
-		it.second.Update();
+		if(static_cast<unsigned>(cit.second) >= trade.size() || !trade[cit.second].isTraded)
+			continue;
+		
+		Price &it = trade[cit.second];
+		it.exports = EXPORT * it.supply;
+		it.supply *= KEEP;
+		it.supply += Random::Normal() * VOLUME;
+		it.Update();
 	}
 }
 
@@ -428,25 +461,47 @@ void System::StepEconomy()
 
 void System::SetSupply(const string &commodity, double tons)
 {
-	auto &it = trade[commodity];
-	it.supply = tons;
-	it.Update();
+	SetSupply(CommodityIndex(commodity), tons);
 }
 
 
 
 double System::Supply(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.supply;
+	return Supply(FindCommodity(commodity));
 }
 
 
 
 double System::Exports(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.exports;
+	return Exports(FindCommodity(commodity));
+}
+
+
+
+// The same, but with the commodity specified by its index.
+void System::SetSupply(int commodity, double tons)
+{
+	Price &it = GetPrice(commodity);
+	it.supply = tons;
+	it.Update();
+}
+
+
+
+double System::Supply(int commodity) const
+{
+	const Price *it = FindPrice(commodity);
+	return it ? it->supply : 0.;
+}
+
+
+
+double System::Exports(int commodity) const
+{
+	const Price *it = FindPrice(commodity);
+	return it ? it->exports : 0.;
 }
 
 
@@ -500,6 +555,27 @@ void System::LoadObject(const DataNode &node, Set<Planet> &planets, int parent)
 
 
 
+// Get the price information for the given commodity, adding it if this
+// system does not trade in it yet.
+System::Price &System::GetPrice(int commodity)
+{
+	if(trade.size() <= static_cast<unsigned>(commodity))
+		trade.resize(commodity + 1);
+	trade[commodity].isTraded = true;
+	return trade[commodity];
+}
+
+
+
+const System::Price *System::FindPrice(int commodity) const
+{
+	if(commodity < 0 || static_cast<unsigned>(commodity) >= trade.size() || !trade[commodity].isTraded)
+		return nullptr;
+	return &trade[commodity];
+}
+
+
+
 void System::Price::SetBase(int base)
 {
 	this->base = base;
@@ -104,6 +104,10 @@ public:
 	// Get the specification of how many asteroids of each type there are.
 	const std::vector<Asteroid> &Asteroids() const;
 	
+	// Get the index of the given commodity. Each commodity name is given an
+	// index the first time it is used, so the trade information for each
+	// system can be stored in a vector instead of being looked up by name.
+	static int CommodityIndex(const std::string &commodity);
 	// Get the price of the given commodity in this system.
 	int Trade(const std::string &commodity) const;
 	// Update the economy. Returns the amount of trade goods this system exports.
@@ -111,6 +115,10 @@ public:
 	void SetSupply(const std::string &commodity, double tons);
 	double Supply(const std::string &commodity) const;
 	double Exports(const std::string &commodity) const;
+	// The same, but with the commodity specified by its index.
+	void SetSupply(int commodity, double tons);
+	double Supply(int commodity) const;
+	double Exports(int commodity) const;
 	
 	// Get the probabilities of various fleets entering this system.
 	const std::vector<FleetProbability> &Fleets() const;
@@ -126,6 +134,8 @@ private:
 		void SetBase(int base);
 		void Update();
 		
+		// Whether this commodity has been given a price or supply at all.
+		bool isTraded = false;
 		int base = 0;
 		int price = 0;
 		double supply = 0.;
@@ -133,6 +143,13 @@ private:
 	};
 	
 	
+private:
+	// Get the price information for the given commodity, adding it if this
+	// system does not trade in it yet.
+	Price &GetPrice(int commodity);
+	const Price *FindPrice(int commodity) const;
+	
+	
 private:
 	// Name and position (within the star map) of this system.
 	std::string name;
@@ -151,8 +168,8 @@ private:
 	std::vector<FleetProbability> fleets;
 	double habitable = 1000.;
 	
-	// Commodity prices.
-	std::map<std::string, Price> trade;
+	// Commodity prices, by commodity index.
+	std::vector<Price> trade;
 };
 
 
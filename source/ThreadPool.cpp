@@ -0,0 +1,136 @@
+/* ThreadPool.cpp
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+namespace {
+	atomic<bool> isSingleThreaded(false);
+}
+
+
+
+// Create a pool with the given number of worker threads, not counting the
+// calling thread. By default, there is one thread for each processor core.
+ThreadPool::ThreadPool(int workers)
+	: next(0)
+{
+	if(workers < 0)
+		workers = static_cast<int>(thread::hardware_concurrency()) - 1;
+	
+	threads.resize(max(0, workers));
+	for(thread &t : threads)
+		t = thread(ref(*this));
+}
+
+
+
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	workCondition.notify_all();
+	for(thread &t : threads)
+		t.join();
+}
+
+
+
+// Run the given function once for each index from 0 to count - 1, and
+// return once all of those calls are complete.
+void ThreadPool::Run(unsigned count, const function<void(unsigned)> &function)
+{
+	if(threads.empty() || count < 2 || isSingleThreaded)
+	{
+		for(unsigned i = 0; i < count; ++i)
+			function(i);
+		return;
+	}
+	
+	{
+		lock_guard<std::mutex> lock(mutex);
+		job = &function;
+		jobCount = count;
+		next = 0;
+		++batch;
+	}
+	workCondition.notify_all();
+	
+	// This thread works on the batch, too.
+	Work(function, count);
+	
+	// Wait for any worker threads that are still finishing up their last job.
+	// Any that have not yet woken up will find that there is no work left.
+	unique_lock<std::mutex> lock(mutex);
+	while(busy)
+		doneCondition.wait(lock);
+	job = nullptr;
+}
+
+
+
+// Force all work to be done in the calling thread. This is for checking
+// that the results do not depend on how work is divided between threads.
+void ThreadPool::SetSingleThreaded(bool singleThreaded)
+{
+	isSingleThreaded = singleThreaded;
+}
+
+
+
+bool ThreadPool::IsSingleThreaded()
+{
+	return isSingleThreaded;
+}
+
+
+
+// Thread entry point.
+void ThreadPool::operator()()
+{
+	unsigned done = 0;
+	unique_lock<std::mutex> lock(mutex);
+	while(true)
+	{
+		while(!quit && batch == done)
+			workCondition.wait(lock);
+		if(quit)
+			return;
+		
+		done = batch;
+		if(!job)
+			continue;
+		
+		const function<void(unsigned)> &work = *job;
+		unsigned workCount = jobCount;
+		++busy;
+		lock.unlock();
+		
+		Work(work, workCount);
+		
+		lock.lock();
+		if(!--busy)
+			doneCondition.notify_all();
+	}
+}
+
+
+
+// Take jobs from the current batch until there are none left.
+void ThreadPool::Work(const function<void(unsigned)> &function, unsigned count)
+{
+	for(unsigned i = next++; i < count; i = next++)
+		function(i);
+}
@@ -0,0 +1,73 @@
+/* ThreadPool.h
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+// Class representing a set of worker threads that can be handed a batch of
+// independent jobs, numbered 0 through count - 1. The thread that hands off the
+// batch also works on it, and then waits until every job is done. Jobs are not
+// done in any particular order, so they should not depend on each other.
+class ThreadPool {
+public:
+	// Create a pool with the given number of worker threads, not counting the
+	// calling thread. By default, there is one thread for each processor core.
+	explicit ThreadPool(int workers = -1);
+	~ThreadPool();
+	
+	// Run the given function once for each index from 0 to count - 1, and
+	// return once all of those calls are complete.
+	void Run(unsigned count, const std::function<void(unsigned)> &function);
+	
+	// Force all work to be done in the calling thread. This is for checking
+	// that the results do not depend on how work is divided between threads.
+	static void SetSingleThreaded(bool singleThreaded = true);
+	static bool IsSingleThreaded();
+	
+	// Thread entry point.
+	void operator()();
+	
+	
+private:
+	// Take jobs from the current batch until there are none left.
+	void Work(const std::function<void(unsigned)> &function, unsigned count);
+	
+	
+private:
+	std::mutex mutex;
+	std::condition_variable workCondition;
+	std::condition_variable doneCondition;
+	
+	// The current batch of jobs. A new batch increments the "batch" counter.
+	const std::function<void(unsigned)> *job = nullptr;
+	unsigned jobCount = 0;
+	unsigned batch = 0;
+	std::atomic<unsigned> next;
+	// The number of worker threads that are still working on this batch.
+	int busy = 0;
+	bool quit = false;
+	
+	std::vector<std::thread> threads;
+};
+
+
+
+#endif
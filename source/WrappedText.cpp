@@ -23,7 +23,7 @@ using namespace std;
 
 
 WrappedText::WrappedText()
-	: font(nullptr), wrapWidth(1000), alignment(JUSTIFIED), height(0)
+	: font(nullptr), wrapWidth(1000), alignment(JUSTIFIED), height(0), needsWrap(true), glyphGeneration(0)
 {
 }
 
@@ -48,6 +48,7 @@ WrappedText::Align WrappedText::Alignment() const
 void WrappedText::SetAlignment(Align align)
 {
 	alignment = align;
+	needsWrap = true;
 }
 
 
@@ -63,6 +64,7 @@ int WrappedText::WrapWidth() const
 void WrappedText::SetWrapWidth(int width)
 {
 	wrapWidth = width;
+	needsWrap = true;
 }
 
 
@@ -93,6 +95,7 @@ int WrappedText::TabWidth() const
 void WrappedText::SetTabWidth(int width)
 {
 	tabWidth = width;
+	needsWrap = true;
 }
 
 
@@ -108,6 +111,7 @@ int WrappedText::LineHeight() const
 void WrappedText::SetLineHeight(int height)
 {
 	lineHeight = height;
+	needsWrap = true;
 }
 
 
@@ -123,6 +127,7 @@ int WrappedText::ParagraphBreak() const
 void WrappedText::SetParagraphBreak(int height)
 {
 	paragraphBreak = height;
+	needsWrap = true;
 }
 
 
@@ -131,18 +136,16 @@ void WrappedText::SetParagraphBreak(int height)
 // always begin at (0, 0).
 void WrappedText::Wrap(const string &str)
 {
-	SetText(str.data(), str.length());
-	
-	Wrap();
+	if(SetText(str.data(), str.length()))
+		Wrap();
 }
 
 
 
 void WrappedText::Wrap(const char *str)
 {
-	SetText(str, strlen(str));
-	
-	Wrap();
+	if(SetText(str, strlen(str)))
+		Wrap();
 }
 
 
@@ -158,8 +161,16 @@ int WrappedText::Height() const
 // Draw the text.
 void WrappedText::Draw(const Point &topLeft, const Color &color) const
 {
-	for(const Word &w : words)
-		font->Draw(text.c_str() + w.Index(), w.Pos() + topLeft, color);
+	if(glyphGeneration != Font::LayoutGeneration())
+	{
+		glyphs.clear();
+		glyphGeneration = Font::LayoutGeneration();
+	}
+	if(glyphs.empty())
+		for(const Word &w : words)
+			font->Layout(text.c_str() + w.Index(), w.Pos(), glyphs);
+	
+	font->DrawLayout(glyphs, topLeft, color);
 }
 
 
@@ -185,14 +196,22 @@ Point WrappedText::Word::Pos() const
 
 
 
-void WrappedText::SetText(const char *it, size_t length)
+// Set the text to be wrapped, and check whether it needs to be wrapped again.
+bool WrappedText::SetText(const char *it, size_t length)
 {
+	if(!needsWrap && !source.compare(0, string::npos, it, length))
+		return false;
+	
 	// Clear any previous word-wrapping data. It becomes invalid as soon as the
 	// underlying text buffer changes.
 	words.clear();
+	glyphs.clear();
+	needsWrap = false;
 	
 	// Reallocate that buffer.
-	text.assign(it, length);
+	source.assign(it, length);
+	text = source;
+	return true;
 }
 
 
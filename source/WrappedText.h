@@ -56,7 +56,8 @@ public:
 	int ParagraphBreak() const;
 	void SetParagraphBreak(int height);
 	
-	// Wrap the given text. Use Draw() to draw it.
+	// Wrap the given text. Use Draw() to draw it. If neither the text nor any
+	// of the formatting has changed, the previous layout is kept.
 	void Wrap(const std::string &str);
 	void Wrap(const char *str);
 	
@@ -68,7 +69,7 @@ public:
 	
 	
 private:
-	void SetText(const char *it, size_t length);
+	bool SetText(const char *it, size_t length);
 	void Wrap();
 	void AdjustLine(unsigned &lineBegin, int &lineWidth, bool isEnd);
 	int Space(char c) const;
@@ -102,9 +103,18 @@ private:
 	int paragraphBreak;
 	Align alignment;
 	
+	// The original text, and a copy of it with a '\0' after each word.
+	std::string source;
 	std::string text;
 	std::vector<Word> words;
 	int height;
+	// Any change to the formatting means the text must be wrapped again.
+	bool needsWrap;
+	// The glyphs for all the words, which are laid out the first time the
+	// text is drawn and then reused until it is wrapped again or the font's
+	// layout generation changes (e.g. underlines are shown or hidden).
+	mutable std::vector<float> glyphs;
+	mutable int glyphGeneration;
 };
 
 
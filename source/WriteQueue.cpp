@@ -0,0 +1,133 @@
+/* WriteQueue.cpp
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "WriteQueue.h"
+
+#include "Files.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+
+
+WriteQueue::WriteQueue()
+	: thread(ref(*this))
+{
+}
+
+
+
+WriteQueue::~WriteQueue()
+{
+	{
+		lock_guard<mutex> lock(writeMutex);
+		isDone = true;
+	}
+	writeCondition.notify_all();
+	thread.join();
+}
+
+
+
+// Queue the given data to be written to the given file. If an older version
+// of that file is still waiting to be written, it is replaced.
+void WriteQueue::Add(const string &path, string data)
+{
+	{
+		lock_guard<mutex> lock(writeMutex);
+		auto it = toWrite.begin();
+		while(it != toWrite.end() && it->path != path)
+			++it;
+		if(it == toWrite.end())
+			it = toWrite.insert(it, Item());
+		
+		it->path = path;
+		it->data = move(data);
+		it->queued = chrono::steady_clock::now();
+	}
+	writeCondition.notify_all();
+}
+
+
+
+// Wait until every file that has been queued is safely on disk.
+void WriteQueue::Wait() const
+{
+	unique_lock<mutex> lock(writeMutex);
+	while(isWriting || !toWrite.empty())
+		writeCondition.wait(lock);
+}
+
+
+
+// Get a summary of how long it took from when each file was queued until
+// it was safely on disk.
+string WriteQueue::Statistics() const
+{
+	lock_guard<mutex> lock(writeMutex);
+	ostringstream out;
+	out << "Wrote " << written << " files (" << (bytesWritten >> 10) << " KB)";
+	if(written)
+		out << fixed << setprecision(1) << ", taking " << 1000. * totalLatency / written
+			<< " ms on average, " << 1000. * maxLatency << " ms at most, and "
+			<< 1000. * lastLatency << " ms for the last one";
+	if(failed)
+		out << "; " << failed << " failed";
+	out << ".";
+	return out.str();
+}
+
+
+
+// Thread entry point.
+void WriteQueue::operator()()
+{
+	unique_lock<mutex> lock(writeMutex);
+	while(true)
+	{
+		// Finish writing everything that was queued before quitting.
+		if(toWrite.empty())
+		{
+			if(isDone)
+				return;
+			writeCondition.wait(lock);
+			continue;
+		}
+		
+		Item item = move(toWrite.front());
+		toWrite.pop_front();
+		isWriting = true;
+		lock.unlock();
+		
+		bool success = Files::SafeWrite(item.path, item.data);
+		double latency = chrono::duration<double>(chrono::steady_clock::now() - item.queued).count();
+		if(!success)
+			Files::LogError("Error: unable to write \"" + item.path + "\".");
+		
+		lock.lock();
+		isWriting = false;
+		if(success)
+		{
+			++written;
+			bytesWritten += item.data.size();
+			totalLatency += latency;
+			maxLatency = max(maxLatency, latency);
+			lastLatency = latency;
+		}
+		else
+			++failed;
+		writeCondition.notify_all();
+	}
+}
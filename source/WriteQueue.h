@@ -0,0 +1,80 @@
+/* WriteQueue.h
+Copyright (c) 2016 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef WRITE_QUEUE_H_
+#define WRITE_QUEUE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+
+// Class for writing files to disk on a background thread, so that the game does
+// not stall while a large file (such as a saved game) is being written. Each
+// file is written to a temporary file that is flushed to the disk and then
+// renamed, so if the game crashes the file is either complete or unchanged.
+// Destroying the queue waits until all the queued files have been written.
+class WriteQueue {
+public:
+	WriteQueue();
+	~WriteQueue();
+	
+	// Queue the given data to be written to the given file. If an older version
+	// of that file is still waiting to be written, it is replaced.
+	void Add(const std::string &path, std::string data);
+	// Wait until every file that has been queued is safely on disk.
+	void Wait() const;
+	// Get a summary of how long it took from when each file was queued until
+	// it was safely on disk.
+	std::string Statistics() const;
+	
+	// Thread entry point.
+	void operator()();
+	
+	
+private:
+	class Item {
+	public:
+		std::string path;
+		std::string data;
+		std::chrono::steady_clock::time_point queued;
+	};
+	
+	
+private:
+	std::list<Item> toWrite;
+	bool isWriting = false;
+	bool isDone = false;
+	// The condition is signaled both when a file is queued and when one has
+	// been written, so the mutex must be mutable for Wait() to use it.
+	mutable std::mutex writeMutex;
+	mutable std::condition_variable writeCondition;
+	
+	// Statistics, in seconds. These are protected by writeMutex.
+	unsigned written = 0;
+	unsigned failed = 0;
+	size_t bytesWritten = 0;
+	double totalLatency = 0.;
+	double maxLatency = 0.;
+	double lastLatency = 0.;
+	
+	std::thread thread;
+};
+
+
+
+#endif
@@ -13,6 +13,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 */
 
 #include "Audio.h"
+#include "Benchmark.h"
 #include "Command.h"
 #include "Conversation.h"
 #include "ConversationPanel.h"
@@ -27,6 +28,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "PlayerInfo.h"
 #include "Preferences.h"
 #include "Screen.h"
+#include "ThreadPool.h"
 #include "UI.h"
 
 #include "gl_header.h"
@@ -57,6 +59,9 @@ int main(int argc, char *argv[])
 {
 	Conversation conversation;
 	bool debugMode = false;
+	bool benchmark = false;
+	bool benchmarkMasks = false;
+	bool benchmarkImages = false;
 	for(const char *const *it = argv + 1; *it; ++it)
 	{
 		string arg = *it;
@@ -74,7 +79,23 @@ int main(int argc, char *argv[])
 			conversation = LoadConversation();
 		else if(arg == "-d" || arg == "--debug")
 			debugMode = true;
+		else if(arg == "--single-thread")
+			ThreadPool::SetSingleThreaded();
+		else if(arg == "--benchmark")
+			benchmark = true;
+		else if(arg == "--benchmark-masks")
+			benchmarkMasks = true;
+		else if(arg == "--benchmark-images")
+			benchmarkImages = true;
 	}
+	// The benchmarks run without any window or graphics.
+	if(benchmark)
+		return Benchmark::Run(argv);
+	if(benchmarkMasks)
+		return Benchmark::RunMasks(argv);
+	if(benchmarkImages)
+		return Benchmark::RunImages(argv);
+	
 	PlayerInfo player;
 	
 	try {
@@ -313,6 +334,8 @@ int main(int argc, char *argv[])
 			// That may have cleared out the menu, in which case we should draw
 			// the game panels instead:
 			(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
+			// Load any sprites that were just drawn but are not loaded yet.
+			GameData::UpdateSprites();
 			
 			SDL_GL_SwapWindow(window);
 			timer.Wait();
@@ -321,6 +344,12 @@ int main(int argc, char *argv[])
 		// If you quit while landed on a planet, save the game.
 		if(player.GetPlanet())
 			player.Save();
+		PlayerInfo::FinishSaving();
+		if(debugMode)
+		{
+			cerr << GameData::SpriteStatistics() << endl;
+			cerr << PlayerInfo::SaveStatistics() << endl;
+		}
 		
 		// The Preferences class reads the screen dimensions, so update them if
 		// the window is full screen:
@@ -354,6 +383,11 @@ void PrintHelp()
 	cerr << "    -r, --resources <path>: load resources from given directory." << endl;
 	cerr << "    -c, --config <path>: save user's files to given directory." << endl;
 	cerr << "    -d, --debug: turn on debugging features (e.g. caps lock slow motion)." << endl;
+	cerr << "    --single-thread: parse data files and run the AI on the main thread." << endl;
+	cerr << "    --texture-budget <MB>: memory for ship, planet, and landscape images (0: no limit)." << endl;
+	cerr << "    --benchmark <system> [<steps> [<seed>]]: time the game engine, without graphics." << endl;
+	cerr << "    --benchmark-masks [<repeats>]: time the collision tests on every ship outline." << endl;
+	cerr << "    --benchmark-images: time reading and decoding every image." << endl;
 	cerr << endl;
 	cerr << "Report bugs to: mzahniser@gmail.com" << endl;
 	cerr << "Home page: <https://endless-sky.github.io>" << endl;